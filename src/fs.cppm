@@ -0,0 +1,528 @@
+module;
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+export module crab_cpp:fs;
+
+import :panic;
+import :option;
+import :result;
+import :string;
+import std;
+
+export namespace crab_cpp::fs
+{
+
+/**
+ * @brief The error type of file system operations
+ */
+struct Error
+{
+    enum class Kind
+    {
+        /**
+         * @brief The operating system reported an error, see Error::code
+         */
+        Io,
+
+        /**
+         * @brief The file content is not valid UTF-8, see Error::utf8_error
+         */
+        InvalidUtf8,
+    };
+
+private:
+    Kind m_kind;
+    std::error_code m_code;
+    size_t m_pos = 0;
+
+    Error(Kind kind, std::error_code code, size_t pos) noexcept : m_kind(kind), m_code(code), m_pos(pos) {}
+
+public:
+    /**
+     * @brief Constructs an Io error from the last operating system error
+     */
+    [[nodiscard]] static auto last_os_error() noexcept -> Error
+    {
+        #ifdef _WIN32
+            return Error(Kind::Io, std::error_code(static_cast<int>(::GetLastError()), std::system_category()), 0);
+        #else
+            return Error(Kind::Io, std::error_code(errno, std::generic_category()), 0);
+        #endif
+    }
+
+    /**
+     * @brief Constructs an InvalidUtf8 error
+     */
+    [[nodiscard]] static auto invalid_utf8(FromUtf8Error error) noexcept -> Error
+    {
+        return Error(Kind::InvalidUtf8, std::error_code(), error.pos);
+    }
+
+    [[nodiscard]] auto kind() const noexcept -> Kind
+    {
+        return this->m_kind;
+    }
+
+    /**
+     * @brief Returns the operating system error code, empty unless the kind is Io
+     */
+    [[nodiscard]] auto code() const noexcept -> std::error_code
+    {
+        return this->m_code;
+    }
+
+    /**
+     * @brief Returns the position of the invalid UTF-8 sequence if the kind is InvalidUtf8
+     */
+    [[nodiscard]] auto utf8_error() const noexcept -> Option<FromUtf8Error>
+    {
+        if (this->m_kind == Kind::InvalidUtf8)
+        {
+            return FromUtf8Error(this->m_pos);
+        }
+
+        return None{};
+    }
+};
+
+/**
+ * @brief A read-only memory mapping of a whole file, the content is not validated
+ */
+struct MappedFile
+{
+private:
+    const std::byte* m_data = nullptr;
+    size_t m_len = 0;
+
+    #ifdef _WIN32
+        HANDLE m_mapping = nullptr;
+    #endif
+
+    MappedFile() noexcept = default;
+
+public:
+    /**
+     * @brief Maps the file at path read-only
+     * @param path The path of the file
+     * @return A Result containing either the mapping or an Io error
+     */
+    [[nodiscard]] static auto open(const std::filesystem::path& path) noexcept -> Result<MappedFile, Error>
+    {
+        auto file = MappedFile();
+
+        #ifdef _WIN32
+            const HANDLE handle = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (handle == INVALID_HANDLE_VALUE)
+            {
+                return Error::last_os_error();
+            }
+
+            LARGE_INTEGER size;
+            if (!::GetFileSizeEx(handle, &size))
+            {
+                const auto error = Error::last_os_error();
+                ::CloseHandle(handle);
+                return error;
+            }
+
+            // Mapping an empty file fails, an empty file is represented without a mapping
+            if (size.QuadPart > 0)
+            {
+                file.m_mapping = ::CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (file.m_mapping == nullptr)
+                {
+                    const auto error = Error::last_os_error();
+                    ::CloseHandle(handle);
+                    return error;
+                }
+
+                file.m_data = static_cast<const std::byte*>(::MapViewOfFile(file.m_mapping, FILE_MAP_READ, 0, 0, 0));
+                if (file.m_data == nullptr)
+                {
+                    const auto error = Error::last_os_error();
+                    ::CloseHandle(handle);
+                    return error;
+                }
+                file.m_len = static_cast<size_t>(size.QuadPart);
+            }
+
+            ::CloseHandle(handle);
+        #else
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return Error::last_os_error();
+            }
+
+            struct stat status;
+            if (::fstat(fd, &status) != 0)
+            {
+                const auto error = Error::last_os_error();
+                ::close(fd);
+                return error;
+            }
+
+            // Mapping an empty file fails, an empty file is represented without a mapping
+            if (status.st_size > 0)
+            {
+                void* data = ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data == MAP_FAILED)
+                {
+                    const auto error = Error::last_os_error();
+                    ::close(fd);
+                    return error;
+                }
+
+                file.m_data = static_cast<const std::byte*>(data);
+                file.m_len = static_cast<size_t>(status.st_size);
+            }
+
+            ::close(fd);
+        #endif
+
+        return file;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept : m_data(other.m_data), m_len(other.m_len)
+    {
+        #ifdef _WIN32
+            this->m_mapping = other.m_mapping;
+            other.m_mapping = nullptr;
+        #endif
+
+        other.m_data = nullptr;
+        other.m_len = 0;
+    }
+
+    ~MappedFile()
+    {
+        #ifdef _WIN32
+            if (this->m_data != nullptr)
+            {
+                ::UnmapViewOfFile(this->m_data);
+            }
+
+            if (this->m_mapping != nullptr)
+            {
+                ::CloseHandle(this->m_mapping);
+            }
+        #else
+            if (this->m_data != nullptr)
+            {
+                ::munmap(const_cast<std::byte*>(this->m_data), this->m_len);
+            }
+        #endif
+    }
+
+    auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+    auto operator=(MappedFile&& other) noexcept -> MappedFile&
+    {
+        if (this != &other)
+        {
+            std::destroy_at(this);
+            std::construct_at(this, std::move(other));
+        }
+
+        return *this;
+    }
+
+public:
+    /**
+     * @brief Returns the mapped bytes
+     */
+    [[nodiscard]] auto as_bytes() const noexcept -> std::span<const std::byte>
+    {
+        return std::span(this->m_data, this->m_len);
+    }
+
+    /**
+     * @brief Returns a pointer to the mapped bytes
+     */
+    [[nodiscard]] auto data() const noexcept -> const std::byte*
+    {
+        return this->m_data;
+    }
+
+    /**
+     * @brief Returns the size of the file in bytes
+     */
+    [[nodiscard]] auto size() const noexcept -> size_t
+    {
+        return this->m_len;
+    }
+
+    /**
+     * @brief Hints the operating system that the mapping will be read sequentially
+     */
+    auto advise_sequential() const noexcept -> void
+    {
+        #ifndef _WIN32
+            if (this->m_data != nullptr)
+            {
+                ::madvise(const_cast<std::byte*>(this->m_data), this->m_len, MADV_SEQUENTIAL);
+            }
+        #endif
+    }
+};
+
+/**
+ * @brief A memory mapped file whose whole content has been validated as UTF-8
+ */
+struct MappedStr
+{
+private:
+    MappedFile m_file;
+
+    explicit MappedStr(MappedFile&& file) noexcept : m_file(std::move(file)) {}
+
+public:
+    /**
+     * @brief Validates the mapped file as a whole
+     * @return A Result containing either the MappedStr or an InvalidUtf8 error
+     */
+    [[nodiscard]] static auto from_file(MappedFile&& file) noexcept -> Result<MappedStr, Error>
+    {
+        file.advise_sequential();
+
+        const auto result = str::from_raw_parts(std::bit_cast<const char*>(file.data()), file.size());
+        if (result.is_err())
+        {
+            return Error::invalid_utf8(result.unwrap_err());
+        }
+
+        return MappedStr(std::move(file));
+    }
+
+    /**
+     * @brief Returns the content as a str
+     */
+    [[nodiscard]] auto as_str() const noexcept -> str
+    {
+        return str::from_bytes_unchecked(this->m_file.data(), this->m_file.size());
+    }
+
+    /**
+     * @brief Returns the size of the file in bytes
+     */
+    [[nodiscard]] auto size() const noexcept -> size_t
+    {
+        return this->m_file.size();
+    }
+
+//operators
+public:
+    [[nodiscard]] auto operator->() const noexcept -> const str*
+    {
+        return std::bit_cast<const str*>(this);
+    }
+};
+
+/**
+ * @brief A memory mapped file whose content is validated as UTF-8 on access, one line or range at a time
+ * @details Use this for files too big to validate up front, only the parts that are actually read are validated.
+ */
+struct LazyMappedStr
+{
+private:
+    MappedFile m_file;
+
+    struct Lines
+    {
+        struct LinesIter
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Result<str, FromUtf8Error>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type*;
+            using reference = const value_type&;
+
+            const std::byte* data = nullptr;
+            size_t len = 0;
+            size_t pos = 0;
+            size_t next = 0;
+            value_type line = str();
+
+            explicit LinesIter() noexcept = default;
+
+            explicit LinesIter(const std::byte* data, size_t len, size_t pos) noexcept : data(data), len(len), pos(pos)
+            {
+                this->read_line();
+            }
+
+            /**
+             * @brief Validates the line starting at pos, errors are reported at their position in the file
+             */
+            auto read_line() noexcept -> void
+            {
+                if (this->pos >= this->len)
+                {
+                    this->pos = this->len;
+                    return;
+                }
+
+                const auto* newline = static_cast<const std::byte*>(std::memchr(this->data + this->pos, '\n', this->len - this->pos));
+                size_t end = newline != nullptr ? static_cast<size_t>(newline - this->data) : this->len;
+                this->next = newline != nullptr ? end + 1 : this->len;
+
+                if (end > this->pos && this->data[end - 1] == std::byte{'\r'} && newline != nullptr)
+                {
+                    end -= 1;
+                }
+
+                const auto result = str::from_raw_parts(std::bit_cast<const char*>(this->data + this->pos), end - this->pos);
+                if (result.is_ok())
+                {
+                    this->line = result.unwrap();
+                }
+                else
+                {
+                    this->line = FromUtf8Error(this->pos + result.unwrap_err().pos);
+                }
+            }
+
+            [[nodiscard]] auto operator*() const noexcept -> reference
+            {
+                return this->line;
+            }
+
+            [[nodiscard]] auto operator->() const noexcept -> pointer
+            {
+                return &this->line;
+            }
+
+            auto operator++() noexcept -> LinesIter&
+            {
+                this->pos = this->next;
+                this->read_line();
+
+                return *this;
+            }
+
+            auto operator++(int) noexcept -> LinesIter
+            {
+                LinesIter temp = *this;
+                ++(*this);
+                return temp;
+            }
+
+            [[nodiscard]] auto operator==(const LinesIter& other) const noexcept -> bool
+            {
+                return this->data == other.data && this->pos == other.pos;
+            }
+        };
+
+        const std::byte* data = nullptr;
+        size_t len = 0;
+
+        [[nodiscard]] auto begin() const noexcept -> LinesIter
+        {
+            return LinesIter(this->data, this->len, 0);
+        }
+
+        [[nodiscard]] auto end() const noexcept -> LinesIter
+        {
+            return LinesIter(this->data, this->len, this->len);
+        }
+
+        using iterator = LinesIter;
+        using const_iterator = LinesIter;
+    };
+
+public:
+    explicit LazyMappedStr(MappedFile&& file) noexcept : m_file(std::move(file)) {}
+
+    /**
+     * @brief Returns an iterator over the lines of the file, each line is validated when the iterator reaches it
+     * @return A Lines iterator yielding Result<str, FromUtf8Error>, with error positions relative to the start of the file
+     */
+    [[nodiscard]] auto lines() const noexcept -> Lines
+    {
+        return Lines{this->m_file.data(), this->m_file.size()};
+    }
+
+    /**
+     * @brief Validates and returns the bytes in [from, to) as a str
+     * @return A Result containing either the str or a FromUtf8Error relative to the start of the file
+     * @note Panics if from or to exceeds the size of the file, or if from is greater than to
+     */
+    [[nodiscard]] auto slice(size_t from, size_t to) const noexcept -> Result<str, FromUtf8Error>
+    {
+        if (from > to || to > this->m_file.size())
+        {
+            panic("Invalid parameter(s) while calling LazyMappedStr::slice, from: {}, to: {}, size: {}", from, to, this->m_file.size());
+        }
+
+        const auto result = str::from_raw_parts(std::bit_cast<const char*>(this->m_file.data() + from), to - from);
+        if (result.is_err())
+        {
+            return FromUtf8Error(from + result.unwrap_err().pos);
+        }
+
+        return result.unwrap();
+    }
+
+    /**
+     * @brief Returns the size of the file in bytes
+     */
+    [[nodiscard]] auto size() const noexcept -> size_t
+    {
+        return this->m_file.size();
+    }
+
+    /**
+     * @brief Validates the whole file
+     * @return A Result containing either the MappedStr or an InvalidUtf8 error
+     */
+    [[nodiscard]] auto validate() && noexcept -> Result<MappedStr, Error>
+    {
+        return MappedStr::from_file(std::move(this->m_file));
+    }
+};
+
+/**
+ * @brief Maps the file at path read-only and validates it as UTF-8
+ * @param path The path of the file
+ * @return A Result containing either the MappedStr or an Error
+ */
+[[nodiscard]] auto map_str(const std::filesystem::path& path) noexcept -> Result<MappedStr, Error>
+{
+    auto file = MappedFile::open(path);
+    if (file.is_err())
+    {
+        return file.unwrap_err();
+    }
+
+    return MappedStr::from_file(std::move(file.unwrap()));
+}
+
+/**
+ * @brief Maps the file at path read-only, without validating it up front
+ * @param path The path of the file
+ * @return A Result containing either the LazyMappedStr or an Io error
+ */
+[[nodiscard]] auto map_str_lazy(const std::filesystem::path& path) noexcept -> Result<LazyMappedStr, Error>
+{
+    auto file = MappedFile::open(path);
+    if (file.is_err())
+    {
+        return file.unwrap_err();
+    }
+
+    return LazyMappedStr(std::move(file.unwrap()));
+}
+
+}
@@ -7,4 +7,7 @@ export import :result;
 
 #ifdef CRAB_CPP_ENABLE_STRING
 export import :string;
+export import :fs;
+export import :par;
+export import :rope;
 #endif
\ No newline at end of file
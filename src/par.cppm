@@ -0,0 +1,388 @@
+export module crab_cpp:par;
+
+import :string;
+import std;
+
+namespace crab_cpp::par_detail
+{
+
+/**
+ * @brief Runs body(task) for every task in [0, tasks) on up to threads threads, the calling thread included.
+ * Idle threads claim the next unprocessed task from a shared counter, so a slow chunk never holds others back.
+ * The first exception thrown by body is rethrown on the calling thread after every thread has stopped.
+ */
+template<typename F>
+auto run(std::size_t tasks, std::size_t threads, F& body) -> void
+{
+    if (tasks == 0)
+    {
+        return;
+    }
+
+    threads = std::min(threads, tasks);
+    if (threads <= 1)
+    {
+        for (std::size_t task = 0; task < tasks; task++)
+        {
+            body(task);
+        }
+
+        return;
+    }
+
+    std::atomic<std::size_t> next = 0;
+    std::atomic<bool> failed = false;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    const auto worker = [&]
+    {
+        for (std::size_t task = next.fetch_add(1, std::memory_order_relaxed); task < tasks && !failed.load(std::memory_order_relaxed); task = next.fetch_add(1, std::memory_order_relaxed))
+        {
+            try
+            {
+                body(task);
+            }
+            catch (...)
+            {
+                const auto lock = std::lock_guard(error_mutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    {
+        auto workers = std::vector<std::jthread>();
+        workers.reserve(threads - 1);
+
+        for (std::size_t i = 1; i < threads; i++)
+        {
+            workers.emplace_back(worker);
+        }
+
+        worker();
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+[[nodiscard]] inline auto search(const std::byte* first, const std::byte* last, const str& pattern) noexcept -> const std::byte*
+{
+    return std::search(first, last, pattern.data(), pattern.data() + pattern.size());
+}
+
+/**
+ * @brief Returns the first match of pattern starting in [from, to), or s.size() if there is none.
+ * The match itself may extend past to.
+ */
+[[nodiscard]] inline auto next_match(const str& s, const str& pattern, std::size_t from, std::size_t to) noexcept -> std::size_t
+{
+    if (from >= to)
+    {
+        return s.size();
+    }
+
+    const auto data = s.data();
+    const auto last = data + std::min(to + pattern.size() - 1, s.size());
+    const auto ptr = search(data + from, last, pattern);
+
+    return ptr != last ? std::size_t(ptr - data) : s.size();
+}
+
+/**
+ * @brief Concatenates the per task results in task order
+ */
+template<typename R>
+[[nodiscard]] auto concat(std::vector<std::vector<R>>&& parts) -> std::vector<R>
+{
+    std::size_t total = 0;
+    for (const auto& part : parts)
+    {
+        total += part.size();
+    }
+
+    auto result = std::vector<R>();
+    result.reserve(total);
+
+    for (auto& part : parts)
+    {
+        std::ranges::move(part, std::back_inserter(result));
+    }
+
+    return result;
+}
+
+/**
+ * @brief Cuts s into chunks of about chunk_size bytes, every chunk but the last one ends right after a '\n'.
+ * Returns the end offset of each chunk.
+ */
+[[nodiscard]] inline auto line_chunks(const str& s, std::size_t chunk_size) -> std::vector<std::size_t>
+{
+    auto ends = std::vector<std::size_t>();
+    const auto data = s.data();
+    std::size_t start = 0;
+
+    do
+    {
+        std::size_t end = s.size();
+        if (s.size() - start > chunk_size)
+        {
+            const auto ptr = static_cast<const std::byte*>(std::memchr(data + start + chunk_size, '\n', s.size() - start - chunk_size));
+            if (ptr != nullptr)
+            {
+                end = std::size_t(ptr - data) + 1;
+            }
+        }
+
+        ends.push_back(end);
+        start = end;
+    } while (start < s.size());
+
+    return ends;
+}
+
+/**
+ * @brief The byte ranges of the parts that str::split yields, given the delimiter positions
+ */
+struct SplitParts
+{
+    const str& s;
+    std::size_t pattern_len;
+    std::span<const std::size_t> positions;
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        if (this->positions.empty())
+        {
+            return 1;
+        }
+
+        // Like str::split, a trailing empty part is not yielded
+        return this->positions.size() + (this->positions.back() + this->pattern_len < this->s.size() ? 1 : 0);
+    }
+
+    [[nodiscard]] auto operator[](std::size_t i) const noexcept -> str
+    {
+        const std::size_t begin = i == 0 ? 0 : this->positions[i - 1] + this->pattern_len;
+        const std::size_t end = i < this->positions.size() ? this->positions[i] : this->s.size();
+
+        return str::from_bytes_unchecked(this->s.data() + begin, end - begin);
+    }
+};
+
+}
+
+export namespace crab_cpp
+{
+
+/**
+ * @brief Controls how the par_* functions divide the work
+ */
+struct ParOptions
+{
+    /**
+     * @brief The maximum number of threads, including the calling thread, 0 means std::thread::hardware_concurrency()
+     */
+    std::size_t threads = 0;
+
+    /**
+     * @brief The approximate number of bytes processed by a single task
+     */
+    std::size_t chunk_size = 1 << 20;
+
+    [[nodiscard]] auto thread_count() const noexcept -> std::size_t
+    {
+        if (this->threads != 0)
+        {
+            return this->threads;
+        }
+
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+};
+
+/**
+ * @brief Finds all matches of the pattern in parallel
+ * @param s The string to search
+ * @param pattern The pattern to search for
+ * @param options The parallelism options
+ * @return The byte index of each match in ascending order, identical to what str::matches yields
+ */
+[[nodiscard]] inline auto par_matches(const str& s, const str& pattern, const ParOptions& options = {}) -> std::vector<std::size_t>
+{
+    if (pattern.empty() || pattern.size() > s.size())
+    {
+        return {};
+    }
+
+    const std::size_t chunk_size = std::max(options.chunk_size, pattern.size());
+    const std::size_t tasks = (s.size() + chunk_size - 1) / chunk_size;
+    auto parts = std::vector<std::vector<std::size_t>>(tasks);
+
+    // Each task collects the non-overlapping matches starting in its chunk, as if the search started at the chunk
+    auto body = [&](std::size_t task)
+    {
+        const std::size_t end = std::min((task + 1) * chunk_size, s.size());
+        for (std::size_t pos = par_detail::next_match(s, pattern, task * chunk_size, end); pos < end; pos = par_detail::next_match(s, pattern, pos + pattern.size(), end))
+        {
+            parts[task].push_back(pos);
+        }
+    };
+    par_detail::run(tasks, options.thread_count(), body);
+
+    // A match that straddles a chunk boundary shifts where the search in the next chunk really starts.
+    // Rescan from there until the rescan meets a match the chunk already found, from which point both agree.
+    auto result = std::vector<std::size_t>();
+    std::size_t last_end = 0;
+
+    for (std::size_t task = 0; task < tasks; task++)
+    {
+        const auto& part = parts[task];
+        const std::size_t end = std::min((task + 1) * chunk_size, s.size());
+        std::size_t i = 0;
+
+        while (i < part.size() && part[i] < last_end)
+        {
+            const std::size_t pos = par_detail::next_match(s, pattern, last_end, end);
+            while (i < part.size() && part[i] < pos)
+            {
+                i++;
+            }
+
+            if (pos >= end || (i < part.size() && part[i] == pos))
+            {
+                break;
+            }
+
+            result.push_back(pos);
+            last_end = pos + pattern.size();
+        }
+
+        if (i < part.size() && part[i] >= last_end)
+        {
+            result.insert(result.end(), part.begin() + i, part.end());
+            last_end = part.back() + pattern.size();
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Calls f on each line of the string in parallel, lines are split the same way as str::lines
+ * @param s The string to split
+ * @param f The function to call, it is called concurrently and in no particular order
+ * @param options The parallelism options
+ */
+template<typename F> requires std::invocable<F&, str>
+auto par_lines_for_each(const str& s, F&& f, const ParOptions& options = {}) -> void
+{
+    const auto ends = par_detail::line_chunks(s, options.chunk_size);
+
+    auto body = [&](std::size_t task)
+    {
+        const std::size_t begin = task == 0 ? 0 : ends[task - 1];
+        const auto chunk = str::from_bytes_unchecked(s.data() + begin, ends[task] - begin);
+
+        for (const auto& line : chunk.lines())
+        {
+            std::invoke(f, line);
+        }
+    };
+    par_detail::run(ends.size(), options.thread_count(), body);
+}
+
+/**
+ * @brief Maps each line of the string in parallel, lines are split the same way as str::lines
+ * @param s The string to split
+ * @param f The function to call, it is called concurrently and in no particular order
+ * @param options The parallelism options
+ * @return The results of f in line order
+ */
+template<typename F, typename R = std::invoke_result_t<F&, str>> requires std::invocable<F&, str> && (!std::is_void_v<R>)
+[[nodiscard]] auto par_lines(const str& s, F&& f, const ParOptions& options = {}) -> std::vector<R>
+{
+    const auto ends = par_detail::line_chunks(s, options.chunk_size);
+    auto parts = std::vector<std::vector<R>>(ends.size());
+
+    auto body = [&](std::size_t task)
+    {
+        const std::size_t begin = task == 0 ? 0 : ends[task - 1];
+        const auto chunk = str::from_bytes_unchecked(s.data() + begin, ends[task] - begin);
+
+        for (const auto& line : chunk.lines())
+        {
+            parts[task].push_back(std::invoke(f, line));
+        }
+    };
+    par_detail::run(ends.size(), options.thread_count(), body);
+
+    return par_detail::concat(std::move(parts));
+}
+
+/**
+ * @brief Calls f on each part of the string split by the pattern in parallel, the parts are the same as str::split yields
+ * @param s The string to split
+ * @param pattern The pattern to split on
+ * @param f The function to call, it is called concurrently and in no particular order
+ * @param options The parallelism options
+ */
+template<typename F> requires std::invocable<F&, str>
+auto par_split_for_each(const str& s, const str& pattern, F&& f, const ParOptions& options = {}) -> void
+{
+    const auto positions = par_matches(s, pattern, options);
+    const auto split = par_detail::SplitParts(s, pattern.size(), positions);
+
+    const std::size_t count = split.size();
+    const std::size_t per_task = std::max<std::size_t>(count / (options.thread_count() * 8), 1);
+    const std::size_t tasks = (count + per_task - 1) / per_task;
+
+    auto body = [&](std::size_t task)
+    {
+        for (std::size_t i = task * per_task; i < std::min((task + 1) * per_task, count); i++)
+        {
+            std::invoke(f, split[i]);
+        }
+    };
+    par_detail::run(tasks, options.thread_count(), body);
+}
+
+/**
+ * @brief Maps each part of the string split by the pattern in parallel, the parts are the same as str::split yields
+ * @param s The string to split
+ * @param pattern The pattern to split on
+ * @param f The function to call, it is called concurrently and in no particular order
+ * @param options The parallelism options
+ * @return The results of f in part order
+ */
+template<typename F, typename R = std::invoke_result_t<F&, str>> requires std::invocable<F&, str> && (!std::is_void_v<R>)
+[[nodiscard]] auto par_split(const str& s, const str& pattern, F&& f, const ParOptions& options = {}) -> std::vector<R>
+{
+    const auto positions = par_matches(s, pattern, options);
+    const auto split = par_detail::SplitParts(s, pattern.size(), positions);
+
+    const std::size_t count = split.size();
+    const std::size_t per_task = std::max<std::size_t>(count / (options.thread_count() * 8), 1);
+    const std::size_t tasks = (count + per_task - 1) / per_task;
+    auto parts = std::vector<std::vector<R>>(tasks);
+
+    auto body = [&](std::size_t task)
+    {
+        for (std::size_t i = task * per_task; i < std::min((task + 1) * per_task, count); i++)
+        {
+            parts[task].push_back(std::invoke(f, split[i]));
+        }
+    };
+    par_detail::run(tasks, options.thread_count(), body);
+
+    return par_detail::concat(std::move(parts));
+}
+
+}
@@ -0,0 +1,1192 @@
+export module crab_cpp:rope;
+
+import :panic;
+import :string;
+import std;
+
+export namespace crab_cpp
+{
+
+/**
+ * @brief A UTF-8 text stored as a B-tree of str chunks, for large texts that are edited in the middle
+ * @details Every node caches the byte, char and line break counts of its subtree, so insert, remove, slice and
+ *          the conversions between byte, char and line indices take O(log n). Chunks never split a code point.
+ */
+struct Rope
+{
+private:
+    static constexpr std::size_t MAX_LEAF_BYTES = 1024;
+    static constexpr std::size_t MIN_LEAF_BYTES = MAX_LEAF_BYTES / 4;
+    static constexpr std::size_t MAX_CHILDREN = 16;
+    static constexpr std::size_t MIN_CHILDREN = MAX_CHILDREN / 4;
+
+    [[nodiscard]] static constexpr auto is_continuation(std::byte byte) noexcept -> bool
+    {
+        return (static_cast<std::uint8_t>(byte) & 0xC0) == 0x80;
+    }
+
+    struct Summary
+    {
+        std::size_t bytes = 0;
+        std::size_t chars = 0;
+        std::size_t newlines = 0;
+
+        [[nodiscard]] static auto of(const str& s) noexcept -> Summary
+        {
+            auto summary = Summary{ s.size(), 0, 0 };
+            for (const auto byte : s.as_bytes())
+            {
+                summary.chars += is_continuation(byte) ? 0 : 1;
+                summary.newlines += byte == std::byte{'\n'} ? 1 : 0;
+            }
+
+            return summary;
+        }
+
+        auto operator+=(const Summary& other) noexcept -> Summary&
+        {
+            this->bytes += other.bytes;
+            this->chars += other.chars;
+            this->newlines += other.newlines;
+
+            return *this;
+        }
+    };
+
+    struct Node
+    {
+        Summary summary;
+        bool leaf = true;
+
+        /**
+         * @brief The chunk of a leaf
+         */
+        String text;
+
+        /**
+         * @brief The children of an internal node, all leaves are at the same depth
+         */
+        std::vector<std::unique_ptr<Node>> children;
+
+        auto update() noexcept -> void
+        {
+            if (this->leaf)
+            {
+                this->summary = Summary::of(this->text.as_str());
+                return;
+            }
+
+            this->summary = Summary();
+            for (const auto& child : this->children)
+            {
+                this->summary += child->summary;
+            }
+        }
+
+        [[nodiscard]] auto is_underfull() const noexcept -> bool
+        {
+            return this->leaf ? this->summary.bytes < MIN_LEAF_BYTES : this->children.size() < MIN_CHILDREN;
+        }
+    };
+
+    std::unique_ptr<Node> m_root;
+
+    [[nodiscard]] static auto make_leaf(String&& text) -> std::unique_ptr<Node>
+    {
+        auto node = std::make_unique<Node>();
+        node->text = std::move(text);
+        node->update();
+
+        return node;
+    }
+
+    [[nodiscard]] static auto make_internal(std::vector<std::unique_ptr<Node>>&& children) -> std::unique_ptr<Node>
+    {
+        auto node = std::make_unique<Node>();
+        node->leaf = false;
+        node->children = std::move(children);
+        node->update();
+
+        return node;
+    }
+
+    [[nodiscard]] static auto clone(const Node& node) -> std::unique_ptr<Node>
+    {
+        if (node.leaf)
+        {
+            return make_leaf(String(node.text));
+        }
+
+        auto children = std::vector<std::unique_ptr<Node>>();
+        children.reserve(node.children.size());
+
+        for (const auto& child : node.children)
+        {
+            children.push_back(clone(*child));
+        }
+
+        return make_internal(std::move(children));
+    }
+
+    /**
+     * @brief Cuts a text into leaves of about equal size, at most MAX_LEAF_BYTES each except for code point rounding
+     */
+    [[nodiscard]] static auto split_text(const str& text) -> std::vector<std::unique_ptr<Node>>
+    {
+        const std::size_t count = std::max<std::size_t>((text.size() + MAX_LEAF_BYTES - 1) / MAX_LEAF_BYTES, 1);
+        auto leaves = std::vector<std::unique_ptr<Node>>();
+        leaves.reserve(count);
+
+        std::size_t start = 0;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            std::size_t end = text.size();
+            if (i + 1 < count)
+            {
+                end = start + (text.size() - start) / (count - i);
+                while (is_continuation(text.data()[end]))
+                {
+                    end -= 1;
+                }
+            }
+
+            leaves.push_back(make_leaf(String(str::from_bytes_unchecked(text.data() + start, end - start))));
+            start = end;
+        }
+
+        return leaves;
+    }
+
+    /**
+     * @brief Groups nodes of the same depth into internal nodes of about equal size, at most MAX_CHILDREN each
+     */
+    [[nodiscard]] static auto group(std::vector<std::unique_ptr<Node>>&& nodes) -> std::vector<std::unique_ptr<Node>>
+    {
+        const std::size_t count = (nodes.size() + MAX_CHILDREN - 1) / MAX_CHILDREN;
+        auto groups = std::vector<std::unique_ptr<Node>>();
+        groups.reserve(count);
+
+        auto it = nodes.begin();
+        for (std::size_t i = 0; i < count; i++)
+        {
+            const auto len = static_cast<std::ptrdiff_t>((nodes.end() - it) / static_cast<std::ptrdiff_t>(count - i));
+            groups.push_back(make_internal(std::vector<std::unique_ptr<Node>>(std::make_move_iterator(it), std::make_move_iterator(it + len))));
+            it += len;
+        }
+
+        return groups;
+    }
+
+    /**
+     * @brief Inserts text at a byte offset of the subtree
+     * @return The nodes split off the node, to be placed right after it
+     */
+    static auto insert_at(Node& node, std::size_t pos, const str& text) -> std::vector<std::unique_ptr<Node>>
+    {
+        if (node.leaf)
+        {
+            const auto old_text = node.text.as_str();
+            auto new_text = String();
+            new_text.reserve(old_text.size() + text.size());
+            new_text.push_str(str::from_bytes_unchecked(old_text.data(), pos));
+            new_text.push_str(text);
+            new_text.push_str(str::from_bytes_unchecked(old_text.data() + pos, old_text.size() - pos));
+
+            if (new_text.size() <= MAX_LEAF_BYTES)
+            {
+                node.text = std::move(new_text);
+                node.update();
+
+                return {};
+            }
+
+            auto leaves = split_text(new_text.as_str());
+            node.text = std::move(leaves.front()->text);
+            node.update();
+            leaves.erase(leaves.begin());
+
+            return leaves;
+        }
+
+        std::size_t index = 0;
+        while (index + 1 < node.children.size() && pos > node.children[index]->summary.bytes)
+        {
+            pos -= node.children[index]->summary.bytes;
+            index += 1;
+        }
+
+        auto extra = insert_at(*node.children[index], pos, text);
+        node.children.insert(
+            node.children.begin() + static_cast<std::ptrdiff_t>(index) + 1,
+            std::make_move_iterator(extra.begin()),
+            std::make_move_iterator(extra.end())
+        );
+
+        if (node.children.size() <= MAX_CHILDREN)
+        {
+            node.update();
+            return {};
+        }
+
+        auto groups = group(std::move(node.children));
+        node.children = std::move(groups.front()->children);
+        node.update();
+        groups.erase(groups.begin());
+
+        return groups;
+    }
+
+    /**
+     * @brief Merges the children at index and index + 1, or rebalances them if they do not fit in one node
+     */
+    static auto merge_children(Node& node, std::size_t index) -> void
+    {
+        auto& left = *node.children[index];
+        auto& right = *node.children[index + 1];
+
+        if (left.leaf)
+        {
+            left.text += right.text;
+
+            if (left.text.size() <= MAX_LEAF_BYTES)
+            {
+                left.update();
+                node.children.erase(node.children.begin() + static_cast<std::ptrdiff_t>(index) + 1);
+
+                return;
+            }
+
+            auto leaves = split_text(left.text.as_str());
+            left.text = std::move(leaves[0]->text);
+            right.text = std::move(leaves[1]->text);
+        }
+        else
+        {
+            std::ranges::move(right.children, std::back_inserter(left.children));
+            right.children.clear();
+
+            if (left.children.size() <= MAX_CHILDREN)
+            {
+                left.update();
+                node.children.erase(node.children.begin() + static_cast<std::ptrdiff_t>(index) + 1);
+
+                return;
+            }
+
+            const auto half = static_cast<std::ptrdiff_t>(left.children.size() / 2);
+            std::ranges::move(left.children.begin() + half, left.children.end(), std::back_inserter(right.children));
+            left.children.erase(left.children.begin() + half, left.children.end());
+        }
+
+        left.update();
+        right.update();
+    }
+
+    /**
+     * @brief Removes the byte range [from, to) of the subtree, the range never covers the whole node
+     */
+    static auto remove_range(Node& node, std::size_t from, std::size_t to) -> void
+    {
+        if (node.leaf)
+        {
+            const auto old_text = node.text.as_str();
+            auto new_text = String();
+            new_text.reserve(old_text.size() - (to - from));
+            new_text.push_str(str::from_bytes_unchecked(old_text.data(), from));
+            new_text.push_str(str::from_bytes_unchecked(old_text.data() + to, old_text.size() - to));
+
+            node.text = std::move(new_text);
+            node.update();
+
+            return;
+        }
+
+        // At most two children are partially covered, the first and the last ones
+        auto touched = std::array<std::size_t, 2>{ node.children.size(), node.children.size() };
+        std::size_t offset = 0;
+        std::size_t index = 0;
+
+        while (index < node.children.size() && offset < to)
+        {
+            const std::size_t begin = offset;
+            const std::size_t end = offset + node.children[index]->summary.bytes;
+            offset = end;
+
+            if (end <= from)
+            {
+                index += 1;
+            }
+            else if (from <= begin && end <= to)
+            {
+                node.children.erase(node.children.begin() + static_cast<std::ptrdiff_t>(index));
+            }
+            else
+            {
+                remove_range(*node.children[index], std::max(from, begin) - begin, std::min(to, end) - begin);
+                touched[begin <= from ? 0 : 1] = index;
+                index += 1;
+            }
+        }
+
+        // Rebalance the higher index first so that the lower one stays valid
+        for (const std::size_t i : { touched[1], touched[0] })
+        {
+            if (i < node.children.size() && node.children.size() > 1 && node.children[i]->is_underfull())
+            {
+                merge_children(node, i + 1 < node.children.size() ? i : i - 1);
+            }
+        }
+
+        node.update();
+    }
+
+    [[nodiscard]] auto leaf_at_byte(std::size_t& pos) const noexcept -> const Node*
+    {
+        const Node* node = this->m_root.get();
+        while (!node->leaf)
+        {
+            std::size_t index = 0;
+            while (index + 1 < node->children.size() && pos >= node->children[index]->summary.bytes)
+            {
+                pos -= node->children[index]->summary.bytes;
+                index += 1;
+            }
+
+            node = node->children[index].get();
+        }
+
+        return node;
+    }
+
+public:
+    /**
+     * @brief Iterates over the chunks of a rope or rope slice in order, each chunk is a valid str
+     */
+    struct ChunksIter
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = str;
+        using pointer = const str*;
+        using reference = const str&;
+
+        std::vector<std::pair<const Node*, std::size_t>> stack;
+        const Node* leaf = nullptr;
+        std::size_t leaf_start = 0;
+        std::size_t from = 0;
+        std::size_t to = 0;
+        str chunk;
+
+        ChunksIter() noexcept = default;
+
+        ChunksIter(const Node* root, std::size_t from, std::size_t to) : from(from), to(to)
+        {
+            if (root == nullptr || from >= to)
+            {
+                return;
+            }
+
+            const Node* node = root;
+            while (!node->leaf)
+            {
+                std::size_t index = 0;
+                while (index + 1 < node->children.size() && from >= this->leaf_start + node->children[index]->summary.bytes)
+                {
+                    this->leaf_start += node->children[index]->summary.bytes;
+                    index += 1;
+                }
+
+                this->stack.emplace_back(node, index);
+                node = node->children[index].get();
+            }
+
+            this->leaf = node;
+            this->settle();
+        }
+
+        [[nodiscard]] auto operator*() const noexcept -> reference
+        {
+            return this->chunk;
+        }
+
+        [[nodiscard]] auto operator->() const noexcept -> pointer
+        {
+            return &this->chunk;
+        }
+
+        auto operator++() -> ChunksIter&
+        {
+            if (this->leaf == nullptr)
+            {
+                return *this;
+            }
+
+            this->leaf_start += this->leaf->summary.bytes;
+            this->leaf = nullptr;
+
+            while (!this->stack.empty())
+            {
+                auto& [node, index] = this->stack.back();
+                if (index + 1 < node->children.size())
+                {
+                    index += 1;
+
+                    const Node* next = node->children[index].get();
+                    while (!next->leaf)
+                    {
+                        this->stack.emplace_back(next, 0);
+                        next = next->children[0].get();
+                    }
+
+                    this->leaf = next;
+                    break;
+                }
+
+                this->stack.pop_back();
+            }
+
+            this->settle();
+            return *this;
+        }
+
+        auto operator++(int) -> ChunksIter
+        {
+            auto temp = *this;
+            ++(*this);
+
+            return temp;
+        }
+
+        [[nodiscard]] auto operator==(const ChunksIter& other) const noexcept -> bool
+        {
+            return this->leaf == other.leaf;
+        }
+
+    private:
+        auto settle() noexcept -> void
+        {
+            if (this->leaf == nullptr || this->leaf_start >= this->to)
+            {
+                this->leaf = nullptr;
+                this->stack.clear();
+
+                return;
+            }
+
+            const auto text = this->leaf->text.as_str();
+            const std::size_t begin = std::max(this->from, this->leaf_start) - this->leaf_start;
+            const std::size_t end = std::min(this->to, this->leaf_start + text.size()) - this->leaf_start;
+            this->chunk = str::from_bytes_unchecked(text.data() + begin, end - begin);
+        }
+    };
+
+    /**
+     * @brief Iterates over the chars of a rope or rope slice in order
+     */
+    struct CharsIter
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = Char;
+        using pointer = const Char*;
+        using reference = const Char&;
+
+        ChunksIter chunks;
+        std::size_t pos = 0;
+        std::size_t len = 0;
+        Char ch;
+
+        CharsIter() noexcept = default;
+
+        explicit CharsIter(ChunksIter chunks) : chunks(std::move(chunks))
+        {
+            this->decode();
+        }
+
+        [[nodiscard]] auto operator*() const noexcept -> reference
+        {
+            return this->ch;
+        }
+
+        [[nodiscard]] auto operator->() const noexcept -> pointer
+        {
+            return &this->ch;
+        }
+
+        auto operator++() -> CharsIter&
+        {
+            if (this->chunks.leaf == nullptr)
+            {
+                return *this;
+            }
+
+            this->pos += this->len;
+            if (this->pos >= this->chunks->size())
+            {
+                ++this->chunks;
+                this->pos = 0;
+            }
+
+            this->decode();
+            return *this;
+        }
+
+        auto operator++(int) -> CharsIter
+        {
+            auto temp = *this;
+            ++(*this);
+
+            return temp;
+        }
+
+        [[nodiscard]] auto operator==(const CharsIter& other) const noexcept -> bool
+        {
+            return this->chunks == other.chunks && this->pos == other.pos;
+        }
+
+    private:
+        auto decode() -> void
+        {
+            if (this->chunks.leaf == nullptr)
+            {
+                return;
+            }
+
+            const auto data = this->chunks->data() + this->pos;
+            const auto lead = static_cast<std::uint8_t>(data[0]);
+
+            std::uint32_t code_point = lead;
+            this->len = 1;
+
+            if (lead >= 0xF0)
+            {
+                code_point = lead & 0x07;
+                this->len = 4;
+            }
+            else if (lead >= 0xE0)
+            {
+                code_point = lead & 0x0F;
+                this->len = 3;
+            }
+            else if (lead >= 0xC0)
+            {
+                code_point = lead & 0x1F;
+                this->len = 2;
+            }
+
+            for (std::size_t i = 1; i < this->len; i++)
+            {
+                code_point = (code_point << 6) | (static_cast<std::uint8_t>(data[i]) & 0x3F);
+            }
+
+            this->ch = Char(code_point);
+        }
+    };
+
+    template<typename Iter>
+    struct Range
+    {
+        Iter first;
+
+        [[nodiscard]] auto begin() const -> Iter
+        {
+            return this->first;
+        }
+
+        [[nodiscard]] auto end() const noexcept -> Iter
+        {
+            return Iter();
+        }
+    };
+
+    /**
+     * @brief A borrowed byte range of a Rope, valid until the rope is modified
+     */
+    struct Slice
+    {
+    private:
+        const Node* m_root = nullptr;
+        std::size_t m_from = 0;
+        std::size_t m_to = 0;
+
+    public:
+        Slice() noexcept = default;
+
+        Slice(const Node* root, std::size_t from, std::size_t to) noexcept : m_root(root), m_from(from), m_to(to) {}
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t
+        {
+            return this->m_to - this->m_from;
+        }
+
+        [[nodiscard]] auto empty() const noexcept -> bool
+        {
+            return this->m_from == this->m_to;
+        }
+
+        /**
+         * @brief Returns an iterator over the str chunks of this slice
+         */
+        [[nodiscard]] auto chunks() const -> Range<ChunksIter>
+        {
+            return Range<ChunksIter>(ChunksIter(this->m_root, this->m_from, this->m_to));
+        }
+
+        /**
+         * @brief Returns an iterator over the chars of this slice
+         */
+        [[nodiscard]] auto chars() const -> Range<CharsIter>
+        {
+            return Range<CharsIter>(CharsIter(ChunksIter(this->m_root, this->m_from, this->m_to)));
+        }
+
+        /**
+         * @brief Copies this slice into a String
+         */
+        template<typename Alloc = std::allocator<std::byte>>
+        [[nodiscard]] auto to_string(const Alloc& alloc = Alloc()) const -> raw::String<Alloc>
+        {
+            auto string = raw::String<Alloc>(alloc);
+            string.reserve(this->size());
+
+            for (const auto& chunk : this->chunks())
+            {
+                string.push_str(chunk);
+            }
+
+            return string;
+        }
+
+        /**
+         * @brief Borrows this slice if it lies within a single chunk, copies it into a String otherwise
+         */
+        [[nodiscard]] auto to_cow() const -> Cow<>
+        {
+            auto it = ChunksIter(this->m_root, this->m_from, this->m_to);
+            if (it == ChunksIter())
+            {
+                return str();
+            }
+
+            const auto first = *it;
+            if (++it == ChunksIter())
+            {
+                return first;
+            }
+
+            return this->to_string();
+        }
+
+        [[nodiscard]] auto operator==(const str& other) const noexcept -> bool
+        {
+            if (this->size() != other.size())
+            {
+                return false;
+            }
+
+            std::size_t offset = 0;
+            for (const auto& chunk : this->chunks())
+            {
+                if (!std::equal(chunk.data(), chunk.data() + chunk.size(), other.data() + offset))
+                {
+                    return false;
+                }
+
+                offset += chunk.size();
+            }
+
+            return true;
+        }
+    };
+
+    /**
+     * @brief Iterates over the lines of a rope, lines are split the same way as str::lines
+     */
+    struct LinesIter
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = Cow<>;
+        using pointer = const Cow<>*;
+        using reference = const Cow<>&;
+
+        const Rope* rope = nullptr;
+        std::size_t line = 0;
+        Cow<> current;
+
+        LinesIter() noexcept = default;
+
+        explicit LinesIter(const Rope& rope) : rope(&rope)
+        {
+            this->load();
+        }
+
+        [[nodiscard]] auto operator*() const noexcept -> reference
+        {
+            return this->current;
+        }
+
+        [[nodiscard]] auto operator->() const noexcept -> pointer
+        {
+            return &this->current;
+        }
+
+        auto operator++() -> LinesIter&
+        {
+            if (this->rope != nullptr)
+            {
+                this->line += 1;
+                this->load();
+            }
+
+            return *this;
+        }
+
+        auto operator++(int) -> LinesIter
+        {
+            auto temp = *this;
+            ++(*this);
+
+            return temp;
+        }
+
+        [[nodiscard]] auto operator==(const LinesIter& other) const noexcept -> bool
+        {
+            return this->rope == other.rope && (this->rope == nullptr || this->line == other.line);
+        }
+
+    private:
+        auto load() -> void
+        {
+            const std::size_t newlines = this->rope->newline_count();
+            const std::size_t start = this->rope->line_to_byte(std::min(this->line, newlines));
+
+            // Like str::lines, text after the last line break is a line only if it is not empty, or if the rope is empty
+            if (this->line > newlines || (this->line == newlines && start == this->rope->size() && newlines > 0))
+            {
+                this->rope = nullptr;
+                this->current = str();
+
+                return;
+            }
+
+            std::size_t end = this->rope->size();
+            if (this->line < newlines)
+            {
+                end = this->rope->line_to_byte(this->line + 1) - 1;
+                if (end > start && this->rope->byte_at(end - 1) == std::byte{'\r'})
+                {
+                    end -= 1;
+                }
+            }
+
+            this->current = this->rope->slice(start, end).to_cow();
+        }
+    };
+
+// constructors
+public:
+    Rope() noexcept = default;
+
+    Rope(const Rope& other) : m_root(other.m_root != nullptr ? clone(*other.m_root) : nullptr) {}
+
+    Rope(Rope&& other) noexcept = default;
+
+    auto operator=(const Rope& other) -> Rope&
+    {
+        if (this != &other)
+        {
+            this->m_root = other.m_root != nullptr ? clone(*other.m_root) : nullptr;
+        }
+
+        return *this;
+    }
+
+    auto operator=(Rope&& other) noexcept -> Rope& = default;
+
+    /**
+     * @brief Creates a Rope holding a copy of the str
+     */
+    [[nodiscard]] static auto from(const str& s) -> Rope
+    {
+        auto rope = Rope();
+        rope.insert(0, s);
+
+        return rope;
+    }
+
+    /**
+     * @brief Creates a Rope holding a copy of the String
+     */
+    template<typename Alloc>
+    [[nodiscard]] static auto from(const raw::String<Alloc>& s) -> Rope
+    {
+        return Rope::from(s.as_str());
+    }
+
+// functions
+public:
+    /**
+     * @brief Returns the length of the rope in bytes
+     */
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return this->m_root != nullptr ? this->m_root->summary.bytes : 0;
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool
+    {
+        return this->size() == 0;
+    }
+
+    /**
+     * @brief Returns the number of chars in the rope
+     */
+    [[nodiscard]] auto char_count() const noexcept -> std::size_t
+    {
+        return this->m_root != nullptr ? this->m_root->summary.chars : 0;
+    }
+
+    /**
+     * @brief Returns the number of '\n' in the rope
+     */
+    [[nodiscard]] auto newline_count() const noexcept -> std::size_t
+    {
+        return this->m_root != nullptr ? this->m_root->summary.newlines : 0;
+    }
+
+    /**
+     * @brief Returns the byte at the given index
+     * @note Panics if index is out of bounds
+     */
+    [[nodiscard]] auto byte_at(std::size_t index) const noexcept -> std::byte
+    {
+        if (index >= this->size())
+        {
+            panic("Index out of bounds while calling Rope::byte_at, index: {}, size: {}", index, this->size());
+        }
+
+        const auto leaf = this->leaf_at_byte(index);
+        return leaf->text.data()[index];
+    }
+
+    /**
+     * @brief Checks if the byte index is the start of a char or the end of the rope
+     */
+    [[nodiscard]] auto is_char_boundary(std::size_t index) const noexcept -> bool
+    {
+        if (index == 0 || index == this->size())
+        {
+            return true;
+        }
+
+        return index < this->size() && !is_continuation(this->byte_at(index));
+    }
+
+    /**
+     * @brief Returns the byte index of the char at char_index, or the size of the rope if char_index is char_count()
+     * @note Panics if char_index is greater than char_count()
+     */
+    [[nodiscard]] auto char_to_byte(std::size_t char_index) const noexcept -> std::size_t
+    {
+        if (char_index > this->char_count())
+        {
+            panic("Char index out of bounds while calling Rope::char_to_byte, index: {}, count: {}", char_index, this->char_count());
+        }
+
+        if (char_index == this->char_count())
+        {
+            return this->size();
+        }
+
+        const Node* node = this->m_root.get();
+        std::size_t bytes = 0;
+
+        while (!node->leaf)
+        {
+            std::size_t index = 0;
+            while (char_index >= node->children[index]->summary.chars)
+            {
+                char_index -= node->children[index]->summary.chars;
+                bytes += node->children[index]->summary.bytes;
+                index += 1;
+            }
+
+            node = node->children[index].get();
+        }
+
+        const auto text = node->text.as_bytes();
+        std::size_t pos = 0;
+
+        for (;; pos++)
+        {
+            if (!is_continuation(text[pos]))
+            {
+                if (char_index == 0)
+                {
+                    break;
+                }
+
+                char_index -= 1;
+            }
+        }
+
+        return bytes + pos;
+    }
+
+    /**
+     * @brief Returns the number of chars that start before the byte index
+     * @note Panics if byte_index is greater than size()
+     */
+    [[nodiscard]] auto byte_to_char(std::size_t byte_index) const noexcept -> std::size_t
+    {
+        if (byte_index > this->size())
+        {
+            panic("Byte index out of bounds while calling Rope::byte_to_char, index: {}, size: {}", byte_index, this->size());
+        }
+
+        if (byte_index == this->size())
+        {
+            return this->char_count();
+        }
+
+        const Node* node = this->m_root.get();
+        std::size_t chars = 0;
+
+        while (!node->leaf)
+        {
+            std::size_t index = 0;
+            while (byte_index >= node->children[index]->summary.bytes)
+            {
+                byte_index -= node->children[index]->summary.bytes;
+                chars += node->children[index]->summary.chars;
+                index += 1;
+            }
+
+            node = node->children[index].get();
+        }
+
+        return chars + Summary::of(str::from_bytes_unchecked(node->text.data(), byte_index)).chars;
+    }
+
+    /**
+     * @brief Returns the byte index where the line starts, line 0 starts at 0 and line n right after the n-th '\n'
+     * @note Panics if line is greater than newline_count()
+     */
+    [[nodiscard]] auto line_to_byte(std::size_t line) const noexcept -> std::size_t
+    {
+        if (line > this->newline_count())
+        {
+            panic("Line index out of bounds while calling Rope::line_to_byte, line: {}, count: {}", line, this->newline_count());
+        }
+
+        if (line == 0)
+        {
+            return 0;
+        }
+
+        const Node* node = this->m_root.get();
+        std::size_t bytes = 0;
+
+        while (!node->leaf)
+        {
+            std::size_t index = 0;
+            while (line > node->children[index]->summary.newlines)
+            {
+                line -= node->children[index]->summary.newlines;
+                bytes += node->children[index]->summary.bytes;
+                index += 1;
+            }
+
+            node = node->children[index].get();
+        }
+
+        const auto text = node->text.as_bytes();
+        std::size_t pos = 0;
+
+        for (; pos < text.size(); pos++)
+        {
+            if (text[pos] == std::byte{'\n'} && --line == 0)
+            {
+                break;
+            }
+        }
+
+        return bytes + pos + 1;
+    }
+
+    /**
+     * @brief Returns the line that contains the byte index, which is the number of '\n' before it
+     * @note Panics if byte_index is greater than size()
+     */
+    [[nodiscard]] auto byte_to_line(std::size_t byte_index) const noexcept -> std::size_t
+    {
+        if (byte_index > this->size())
+        {
+            panic("Byte index out of bounds while calling Rope::byte_to_line, index: {}, size: {}", byte_index, this->size());
+        }
+
+        if (byte_index == this->size())
+        {
+            return this->newline_count();
+        }
+
+        const Node* node = this->m_root.get();
+        std::size_t lines = 0;
+
+        while (!node->leaf)
+        {
+            std::size_t index = 0;
+            while (byte_index >= node->children[index]->summary.bytes)
+            {
+                byte_index -= node->children[index]->summary.bytes;
+                lines += node->children[index]->summary.newlines;
+                index += 1;
+            }
+
+            node = node->children[index].get();
+        }
+
+        return lines + Summary::of(str::from_bytes_unchecked(node->text.data(), byte_index)).newlines;
+    }
+
+    /**
+     * @brief Inserts a str at the given byte index
+     * @param index The byte index to insert at
+     * @param s The str to insert
+     * @note Panics if index is out of bounds or not on a char boundary
+     */
+    auto insert(std::size_t index, const str& s) -> void
+    {
+        if (!this->is_char_boundary(index))
+        {
+            panic("Index not on a char boundary while calling Rope::insert, index: {}, size: {}", index, this->size());
+        }
+
+        if (s.empty())
+        {
+            return;
+        }
+
+        if (this->m_root == nullptr)
+        {
+            this->m_root = make_leaf(String());
+        }
+
+        auto extra = insert_at(*this->m_root, index, s);
+        if (extra.empty())
+        {
+            return;
+        }
+
+        // The root was split, grow the tree by as many levels as needed
+        extra.insert(extra.begin(), std::move(this->m_root));
+        do
+        {
+            extra = group(std::move(extra));
+        } while (extra.size() > 1);
+
+        this->m_root = std::move(extra.front());
+    }
+
+    /**
+     * @brief Appends a str to the end of the rope
+     */
+    auto push_str(const str& s) -> void
+    {
+        this->insert(this->size(), s);
+    }
+
+    /**
+     * @brief Removes the byte range [from, to)
+     * @note Panics if the range is out of bounds, or if from or to is not on a char boundary
+     */
+    auto remove(std::size_t from, std::size_t to) -> void
+    {
+        if (from > to || !this->is_char_boundary(from) || !this->is_char_boundary(to))
+        {
+            panic("Invalid range while calling Rope::remove, from: {}, to: {}, size: {}", from, to, this->size());
+        }
+
+        if (from == to)
+        {
+            return;
+        }
+
+        if (from == 0 && to == this->size())
+        {
+            this->m_root.reset();
+            return;
+        }
+
+        remove_range(*this->m_root, from, to);
+
+        while (!this->m_root->leaf && this->m_root->children.size() == 1)
+        {
+            auto child = std::move(this->m_root->children.front());
+            this->m_root = std::move(child);
+        }
+    }
+
+    /**
+     * @brief Returns a view of the byte range [from, to), valid until the rope is modified
+     * @note Panics if the range is out of bounds, or if from or to is not on a char boundary
+     */
+    [[nodiscard]] auto slice(std::size_t from, std::size_t to) const noexcept -> Slice
+    {
+        if (from > to || !this->is_char_boundary(from) || !this->is_char_boundary(to))
+        {
+            panic("Invalid range while calling Rope::slice, from: {}, to: {}, size: {}", from, to, this->size());
+        }
+
+        return Slice(this->m_root.get(), from, to);
+    }
+
+    /**
+     * @brief Returns a view of the whole rope
+     */
+    [[nodiscard]] auto as_slice() const noexcept -> Slice
+    {
+        return Slice(this->m_root.get(), 0, this->size());
+    }
+
+    /**
+     * @brief Returns an iterator over the str chunks of the rope
+     */
+    [[nodiscard]] auto chunks() const -> Range<ChunksIter>
+    {
+        return this->as_slice().chunks();
+    }
+
+    /**
+     * @brief Returns an iterator over the chars of the rope
+     */
+    [[nodiscard]] auto chars() const -> Range<CharsIter>
+    {
+        return this->as_slice().chars();
+    }
+
+    /**
+     * @brief Returns an iterator over the lines of the rope, a line is borrowed unless it spans several chunks
+     */
+    [[nodiscard]] auto lines() const -> Range<LinesIter>
+    {
+        return Range<LinesIter>(LinesIter(*this));
+    }
+
+    /**
+     * @brief Copies the rope into a String
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    [[nodiscard]] auto to_string(const Alloc& alloc = Alloc()) const -> raw::String<Alloc>
+    {
+        return this->as_slice().to_string(alloc);
+    }
+
+    [[nodiscard]] auto operator==(const str& other) const noexcept -> bool
+    {
+        return this->as_slice() == other;
+    }
+};
+
+}
@@ -32,12 +32,67 @@ struct compressed_pair<T1, T2, false>
     T1 _first;
     T2 second;
 
-    constexpr compressed_pair(T1& x, const T2& y) noexcept : _first(x), second(y) {}
+    constexpr compressed_pair(const T1& x, const T2& y) noexcept : _first(x), second(y) {}
 
     [[nodiscard]] constexpr auto first() noexcept -> T1& { return this->_first; }
     [[nodiscard]] constexpr auto first() const noexcept -> const T1& { return this->_first; }
 };
 
+/**
+ * @brief Holds an optional T by value and stays copy assignable even if T is only copy constructible, like the
+ * copyable-box of the standard range adaptors. Iterators use it to carry a pattern that may be a capturing lambda.
+ * @tparam T The held type
+ */
+template<typename T>
+struct copyable_box
+{
+    std::optional<T> value;
+
+    constexpr copyable_box() noexcept = default;
+    constexpr explicit copyable_box(const T& value) : value(value) {}
+
+    constexpr copyable_box(const copyable_box&) = default;
+    constexpr copyable_box(copyable_box&&) = default;
+
+    constexpr auto operator=(const copyable_box& other) -> copyable_box&
+    {
+        if (this != &other)
+        {
+            this->value.reset();
+            if (other.value.has_value())
+            {
+                this->value.emplace(*other.value);
+            }
+        }
+
+        return *this;
+    }
+
+    constexpr auto operator=(copyable_box&& other) -> copyable_box&
+    {
+        if (this != &other)
+        {
+            this->value.reset();
+            if (other.value.has_value())
+            {
+                this->value.emplace(std::move(*other.value));
+            }
+        }
+
+        return *this;
+    }
+
+    [[nodiscard]] constexpr auto operator*() const noexcept -> const T&
+    {
+        return *this->value;
+    }
+
+    [[nodiscard]] constexpr auto operator->() const noexcept -> const T*
+    {
+        return std::addressof(*this->value);
+    }
+};
+
 struct plain_str
 {
     const std::byte* data = nullptr;
@@ -110,2477 +165,7090 @@ public:
     using const_iterator = Iter;
 };
 
-export namespace crab_cpp
-{
-
-struct FromUtf8Error
-{
-    /**
-     * @brief The position where the invalid UTF-8 sequence was found
-     */
-    size_t pos;
-
-    /**
-     * @brief Constructs a FromUtf8Error with the given position
-     */
-    constexpr explicit FromUtf8Error(size_t pos) noexcept : pos(pos) {}
-};
-
 /**
- * @brief Validates if the given string is valid UTF-8
- * @param str The string to validate
- * @param len The length of the string in bytes
- * @return true if the string is valid UTF-8
+ * @brief Word-at-a-time helpers operating on 8 bytes packed into a std::uint64_t
  */
-[[nodiscard]] constexpr auto is_valid_utf8(const std::byte* str, size_t len) noexcept -> bool
+namespace swar
 {
-    if (str == nullptr || len == 0)
-    {
-        return true;
-    }
+    constexpr std::uint64_t LO = 0x0101010101010101ULL;
+    constexpr std::uint64_t HI = 0x8080808080808080ULL;
 
-    utf8proc_int32_t codepoint;
-    size_t pos = 0;
-
-    while (pos < len)
+    [[nodiscard]] inline auto load(const std::byte* ptr) noexcept -> std::uint64_t
     {
-        const auto advance = utf8proc_iterate(
-            reinterpret_cast<const utf8proc_uint8_t*>(str + pos),
-            len - pos,
-            &codepoint
-        );
+        std::uint64_t word;
+        std::memcpy(&word, ptr, sizeof(word));
 
-        if (advance < 0)
-        {
-            return false;
-        }
-        pos += advance;
+        return word;
     }
-    return true;
-}
 
-[[nodiscard]] constexpr auto is_valid_utf8(const char* str, size_t len) noexcept -> bool
-{
-    return is_valid_utf8(std::bit_cast<const std::byte*>(str), len);
-}
-
-/**
- * @brief A class representing a Unicode scalar value
- */
-struct Char
-{
-private:
-    std::uint32_t m_value = 0;
-
-public:
-    /**
-     * @brief Default constructor
-     */
-    constexpr explicit Char() noexcept = default;
-
-    /**
-     * @brief Constructs a Char from a Unicode scalar value
-     * @param value The Unicode scalar value
-     * @note Panics If the value is not a valid Unicode scalar value
-     */
-    constexpr explicit Char(std::uint32_t value) : m_value(value)
+    [[nodiscard]] constexpr auto has_non_ascii(std::uint64_t word) noexcept -> bool
     {
-        if (!is_valid_scalar_value(value))
-        {
-            panic("Invalid Unicode scalar value");
-        }
+        return (word & HI) != 0;
     }
 
-private:
     /**
-     * @param value The value to check
-     * @return true if the value is a valid Unicode scalar value
+     * @brief Returns a word with the high bit set in every byte that is an ASCII uppercase letter
      */
-    [[nodiscard]] static constexpr auto is_valid_scalar_value(std::uint32_t value) noexcept -> bool
+    [[nodiscard]] constexpr auto ascii_uppercase_mask(std::uint64_t word) noexcept -> std::uint64_t
     {
-        // Unicode scalar values are in the range [0, 0x10FFFF] excluding surrogate pairs
-        return value <= 0x10FFFF && (value < 0xD800 || value > 0xDFFF);
-    }
+        // Clearing the high bits first keeps the additions from carrying into the next byte
+        const auto heptets = word & ~HI;
+        const auto ge_upper_a = heptets + LO * (0x80 - 'A');
+        const auto gt_upper_z = heptets + LO * (0x7F - 'Z');
 
-public:
-    /**
-     * @return The Unicode scalar value
-     */
-    [[nodiscard]] constexpr auto code_point() const noexcept -> std::uint32_t
-    {
-        return this->m_value;
+        return (ge_upper_a ^ gt_upper_z) & ~word & HI;
     }
 
     /**
-     * @return true if this char is an ASCII character
+     * @brief Returns a word with the high bit set in every byte that is an ASCII lowercase letter
      */
-    [[nodiscard]] constexpr auto is_ascii() const noexcept -> bool
+    [[nodiscard]] constexpr auto ascii_lowercase_mask(std::uint64_t word) noexcept -> std::uint64_t
     {
-        return this->m_value <= 0x7F;
-    }
+        const auto heptets = word & ~HI;
+        const auto ge_lower_a = heptets + LO * (0x80 - 'a');
+        const auto gt_lower_z = heptets + LO * (0x7F - 'z');
 
-    /**
-     * @return true if this char is an ASCII alphabetic character
-     */
-    [[nodiscard]] constexpr auto is_ascii_alphabetic() const noexcept -> bool
-    {
-        return (this->m_value >= static_cast<std::uint32_t>('a') && this->m_value <= static_cast<std::uint32_t>('z')) ||
-               (this->m_value >= static_cast<std::uint32_t>('A') && this->m_value <= static_cast<std::uint32_t>('Z'));
+        return (ge_lower_a ^ gt_lower_z) & ~word & HI;
     }
 
     /**
-     * @return true if this char is an ASCII alphanumeric character
+     * @brief Lowercases the ASCII letters among 8 bytes at once, other bytes are unchanged
      */
-    [[nodiscard]] constexpr auto is_ascii_alphanumeric() const noexcept -> bool
+    [[nodiscard]] constexpr auto to_ascii_lowercase(std::uint64_t word) noexcept -> std::uint64_t
     {
-        return (this->m_value >= static_cast<std::uint32_t>('0') && this->m_value <= static_cast<std::uint32_t>('9')) ||
-               (this->m_value >= static_cast<std::uint32_t>('a') && this->m_value <= static_cast<std::uint32_t>('z')) ||
-               (this->m_value >= static_cast<std::uint32_t>('A') && this->m_value <= static_cast<std::uint32_t>('Z'));
+        return word | (ascii_uppercase_mask(word) >> 2);
     }
 
     /**
-     * @return true if this char is an ASCII lowercase character
+     * @brief Uppercases the ASCII letters among 8 bytes at once, other bytes are unchanged
      */
-    [[nodiscard]] constexpr auto is_ascii_lowercase() const noexcept -> bool
+    [[nodiscard]] constexpr auto to_ascii_uppercase(std::uint64_t word) noexcept -> std::uint64_t
     {
-        return this->m_value >= static_cast<std::uint32_t>('a') && this->m_value <= static_cast<std::uint32_t>('z');
+        return word & ~(ascii_lowercase_mask(word) >> 2);
     }
 
     /**
-     * @brief Returns true if this char is an ASCII uppercase character
-     * @return true if this char is an ASCII uppercase character
+     * @brief Loads 8 bytes so that the first byte ends up in the lowest byte of the word
      */
-    [[nodiscard]] constexpr auto is_ascii_uppercase() const noexcept -> bool
+    [[nodiscard]] inline auto load_le(const std::byte* ptr) noexcept -> std::uint64_t
     {
-        return this->m_value >= static_cast<std::uint32_t>('A') && this->m_value <= static_cast<std::uint32_t>('Z');
+        if constexpr (std::endian::native == std::endian::big)
+        {
+            return std::byteswap(load(ptr));
+        }
+        else
+        {
+            return load(ptr);
+        }
     }
 
     /**
-     * @details Checks if the value is an ASCII control character: U+0000 NUL ..= U+001F UNIT SEPARATOR, or U+007F DELETE.
-     *          Note that most ASCII whitespace characters are control characters, but SPACE is not.
-     * @return true if this char is an ASCII control character
+     * @brief Returns true if all 8 bytes of a word loaded by load_le are ASCII digits
      */
-    [[nodiscard]] constexpr auto is_ascii_control() const noexcept -> bool
+    [[nodiscard]] constexpr auto is_eight_digits(std::uint64_t word) noexcept -> bool
     {
-        return (this->m_value <= 0x1F) || (this->m_value == 0x7F);
+        return ((word & 0xF0F0F0F0F0F0F0F0ULL) | (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
     }
 
     /**
-     * @details Checks if the value is an ASCII whitespace character:
-     *          - U+0020 SPACE
-     *          - U+0009 HORIZONTAL TAB
-     *          - U+000A LINE FEED
-     *          - U+000C FORM FEED
-     *          - U+000D CARRIAGE RETURN
-     * @return true if this char is an ASCII whitespace character
+     * @brief Converts 8 ASCII digits of a word loaded by load_le to their value, the first byte is the most significant digit
      */
-    [[nodiscard]] constexpr auto is_ascii_whitespace() const noexcept -> bool
+    [[nodiscard]] constexpr auto parse_eight_digits(std::uint64_t word) noexcept -> std::uint32_t
     {
-        return (this->m_value == 0x20) || // SPACE
-               (this->m_value == 0x09) || // HORIZONTAL TAB
-               (this->m_value == 0x0A) || // LINE FEED
-               (this->m_value == 0x0C) || // FORM FEED
-               (this->m_value == 0x0D);   // CARRIAGE RETURN
+        constexpr std::uint64_t mask = 0x000000FF000000FFULL;
+        constexpr std::uint64_t mul1 = 100 + (1000000ULL << 32);
+        constexpr std::uint64_t mul2 = 1 + (10000ULL << 32);
+
+        // Combine adjacent digits into 2 digit numbers, then into 4, then into 8
+        word -= 0x3030303030303030ULL;
+        word = (word * 10) + (word >> 8);
+
+        return static_cast<std::uint32_t>((((word & mask) * mul1) + (((word >> 16) & mask) * mul2)) >> 32);
     }
 
     /**
-     * @brief Checks if the value is an ASCII decimal digit: U+0030 '0' ..= U+0039 '9'.
+     * @brief Returns a word with the high bit set in every byte equal to the given byte, without false positives
      */
-    [[nodiscard]] constexpr auto is_ascii_digit() const noexcept -> bool
+    [[nodiscard]] constexpr auto eq_mask(std::uint64_t word, std::uint8_t byte) noexcept -> std::uint64_t
     {
-        return this->m_value >= static_cast<std::uint32_t>('0') && this->m_value <= static_cast<std::uint32_t>('9');
+        // A byte of diff is zero only if neither its low 7 bits nor its high bit are set
+        const auto diff = word ^ (LO * byte);
+        return ~(((diff & ~HI) + ~HI) | diff) & HI;
     }
 
     /**
-     * @brief Checks if the value is an ASCII hexadecimal digit: U+0030 '0' ..= U+0039 '9', U+0041 'A' ..= U+0046 'F', or U+0061 'a' ..= U+0066 'f'.
+     * @brief Returns the length of the leading run of ASCII bytes
      */
-    [[nodiscard]] constexpr auto is_ascii_hexdigit() const noexcept -> bool
+    [[nodiscard]] inline auto ascii_prefix_len(const std::byte* data, size_t len) noexcept -> size_t
     {
-        return this->is_ascii_digit() ||
-               (this->m_value >= static_cast<std::uint32_t>('A') && this->m_value <= static_cast<std::uint32_t>('F')) ||
-               (this->m_value >= static_cast<std::uint32_t>('a') && this->m_value <= static_cast<std::uint32_t>('f'));
-    }
-
-// operators
-public:
-    constexpr auto operator==(const Char& other) const noexcept -> bool = default;
-};
+        size_t pos = 0;
 
-namespace raw
-{
+        while (pos + 8 <= len && !has_non_ascii(load(data + pos)))
+        {
+            pos += 8;
+        }
 
-template<typename Alloc>
-struct String;
+        while (pos < len && static_cast<std::uint8_t>(data[pos]) < 0x80)
+        {
+            pos += 1;
+        }
 
+        return pos;
+    }
 }
 
-struct str
+/**
+ * @brief Conversions between UTF-8 and UTF-16, UTF-32 and Latin-1.
+ * Each conversion is split into a pass that measures the exact output length and a pass that writes the output,
+ * so the caller allocates once. Both passes handle runs of ASCII a word at a time.
+ */
+namespace transcode
 {
-    using pointer = const std::byte*;
+    [[nodiscard]] constexpr auto is_surrogate(std::uint32_t unit) noexcept -> bool
+    {
+        return (unit & 0xF800) == 0xD800;
+    }
 
-private:
-    pointer m_data;
-    size_t m_len;
+    [[nodiscard]] constexpr auto is_high_surrogate(std::uint32_t unit) noexcept -> bool
+    {
+        return (unit & 0xFC00) == 0xD800;
+    }
 
-    /**
-     * @brief Private constructor for internal use
-     */
-    constexpr str(pointer data, size_t len) noexcept : m_data(data), m_len(len) {}
+    [[nodiscard]] constexpr auto is_low_surrogate(std::uint32_t unit) noexcept -> bool
+    {
+        return (unit & 0xFC00) == 0xDC00;
+    }
 
-public:
-    /**
-     * @brief Default constructor
-     */
-    constexpr str() noexcept : m_data(nullptr), m_len(0) {}
+    [[nodiscard]] constexpr auto is_scalar_value(std::uint32_t cp) noexcept -> bool
+    {
+        return cp < 0xD800 || (cp > 0xDFFF && cp < 0x110000);
+    }
 
     /**
-     * @brief Constructs a str from a plain_str
-     * @param s The plain_str to construct from
+     * @brief Returns true if the 4 UTF-16 code units starting at ptr are all ASCII
      */
-    constexpr str(const plain_str& s) noexcept : m_data(s.data), m_len(s.len) {}
-
-public:
-    [[nodiscard]] constexpr auto begin() const noexcept -> const std::byte*
+    [[nodiscard]] inline auto is_ascii_utf16x4(const char16_t* ptr) noexcept -> bool
     {
-        return std::bit_cast<const std::byte*>(this->m_data);
+        std::uint64_t word;
+        std::memcpy(&word, ptr, sizeof(word));
+
+        // Every code unit is a 16 bit lane of the word whatever the byte order is
+        return (word & 0xFF80FF80FF80FF80ULL) == 0;
     }
 
-    [[nodiscard]] constexpr auto end() const noexcept -> const std::byte*
+    /**
+     * @brief Returns the number of bytes of the UTF-8 encoding of a Unicode scalar value
+     */
+    [[nodiscard]] constexpr auto utf8_width(std::uint32_t cp) noexcept -> size_t
     {
-        return std::bit_cast<const std::byte*>(this->m_data + this->m_len);
+        return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
     }
 
     /**
-     * @brief Creates a string view from a pointer and length
-     * @param data Pointer to string data
-     * @param len Length of the string
-     * @return A Result containing either a str or a FromUtf8Error
+     * @brief Writes the UTF-8 encoding of a Unicode scalar value and returns the end of the written bytes
      */
-    [[nodiscard]] static constexpr auto from_raw_parts(const char* data, size_t len) noexcept -> Result<str, FromUtf8Error>
+    inline auto encode_utf8(std::uint32_t cp, std::byte* out) noexcept -> std::byte*
     {
-        if (data == nullptr && len > 0)
+        if (cp < 0x80)
         {
-            return FromUtf8Error(0);
+            out[0] = std::byte(cp);
+            return out + 1;
         }
 
-        if (!is_valid_utf8(data, len))
+        if (cp < 0x800)
         {
-            // Find the position of the invalid UTF-8 sequence
-            utf8proc_int32_t codepoint;
-            size_t pos = 0;
-
-            while (pos < len)
-            {
-                const auto result = utf8proc_iterate(
-                    reinterpret_cast<const utf8proc_uint8_t*>(data + pos),
-                    len - pos,
-                    &codepoint
-                );
+            out[0] = std::byte(0xC0 | (cp >> 6));
+            out[1] = std::byte(0x80 | (cp & 0x3F));
+            return out + 2;
+        }
 
-                if (result < 0)
-                {
-                    return FromUtf8Error(pos);
-                }
-                pos += result;
-            }
+        if (cp < 0x10000)
+        {
+            out[0] = std::byte(0xE0 | (cp >> 12));
+            out[1] = std::byte(0x80 | ((cp >> 6) & 0x3F));
+            out[2] = std::byte(0x80 | (cp & 0x3F));
+            return out + 3;
         }
 
-        return str(std::bit_cast<pointer>(data), len);
+        out[0] = std::byte(0xF0 | (cp >> 18));
+        out[1] = std::byte(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = std::byte(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = std::byte(0x80 | (cp & 0x3F));
+        return out + 4;
     }
 
     /**
-     * @brief Constructs a str from a pointer and length
-     * @param data Pointer to string data
-     * @param len Length of the string
-     * @return A str containing the string data
+     * @brief Measures the UTF-8 encoding of UTF-16 text, an unpaired surrogate counts as U+FFFD
+     * @return The length in bytes and the index of the first unpaired surrogate, or units.size() if there is none
      */
-    [[nodiscard]] static constexpr auto from_bytes_unchecked(pointer data, size_t len) noexcept -> str
+    [[nodiscard]] inline auto utf8_len_of_utf16(std::u16string_view units) noexcept -> std::pair<size_t, size_t>
     {
-        return str(data, len);
+        size_t len = 0;
+        size_t invalid = units.size();
+        size_t i = 0;
+
+        while (i < units.size())
+        {
+            if (i + 4 <= units.size() && is_ascii_utf16x4(units.data() + i))
+            {
+                len += 4;
+                i += 4;
+                continue;
+            }
+
+            const std::uint32_t unit = units[i];
+            if (is_high_surrogate(unit) && i + 1 < units.size() && is_low_surrogate(units[i + 1]))
+            {
+                len += 4;
+                i += 2;
+                continue;
+            }
+
+            if (is_surrogate(unit))
+            {
+                invalid = std::min(invalid, i);
+            }
+
+            len += utf8_width(is_surrogate(unit) ? 0xFFFD : unit);
+            i += 1;
+        }
+
+        return std::pair(len, invalid);
     }
 
     /**
-     * @brief Creates a string view from a null-terminated, UTF-8 encoded C style string
-     * @param data Pointer to null-terminated string
-     * @return A Result containing either a str or a FromUtf8Error
+     * @brief Writes the UTF-8 encoding of UTF-16 text, an unpaired surrogate is written as U+FFFD
+     * @return The end of the written bytes
      */
-    [[nodiscard]] static constexpr auto from(const char* data) noexcept -> Result<str, FromUtf8Error>
+    inline auto utf16_to_utf8(std::u16string_view units, std::byte* out) noexcept -> std::byte*
     {
-        return str::from_raw_parts(data, data != nullptr ? std::strlen(data) : 0);
-    }
-
-public:
-    /**
-     * @brief Returns a byte slice of this str's contents
-     * @return A span containing the string's bytes
-     */
-    [[nodiscard]] constexpr auto as_bytes() const noexcept -> std::span<const std::byte>
-    {
-        return std::span(this->m_data, this->m_len);
-    }
-
-    /**
-     * @brief Returns C-style string of this str's contents
-     * @return A span containing the string's bytes
-     */
-    [[nodiscard]] constexpr auto as_raw() const noexcept -> const char*
-    {
-        return std::bit_cast<const char*>(this->m_data);
-    }
-
-    /**
-     * @brief Returns a C-style string of this str's contents
-     * @return A C-style string of this str's contents
-     */
-    [[nodiscard]] constexpr auto c_str() const noexcept -> const char*
-    {
-        return std::bit_cast<const char*>(this->m_data);
-    }
-
-    /**
-     * @brief Checks if this string contains the given pattern
-     * @param pattern The pattern to search for
-     * @return true if this string contains the pattern
-     */
-    [[nodiscard]] constexpr auto contains(const str& pattern) const noexcept -> bool
-    {
-        if (pattern.m_len > this->m_len)
-        {
-            return false;
-        }
+        size_t i = 0;
 
-        if (pattern.m_len == 0)
+        while (i < units.size())
         {
-            return true;
-        }
-
-        // Create spans for the current string and pattern
-        std::span<const std::byte> haystack(this->m_data, this->m_len);
-        std::span<const std::byte> needle(pattern.m_data, pattern.m_len);
-
-        // Use std::ranges::search to find the pattern
-        auto result = std::ranges::search(haystack, needle);
-        return !result.empty();
-    }
-
-    /**
-     * @brief Returns a pointer to the string data
-     */
-    [[nodiscard]] constexpr auto data() const noexcept -> pointer
-    {
-        return this->m_data;
-    }
-
-    /**
-     * @brief Returns if the string is empty
-     */
-    [[nodiscard]] constexpr auto empty() const noexcept -> bool
-    {
-        return this->m_len == 0;
-    }
+            if (i + 4 <= units.size() && is_ascii_utf16x4(units.data() + i))
+            {
+                for (size_t k = 0; k < 4; k++)
+                {
+                    out[k] = std::byte(units[i + k]);
+                }
 
-    /**
-     * @brief Checks that two strings are an ASCII case-insensitive match.
-     * Same as to_ascii_lowercase(a) == to_ascii_lowercase(b), but without allocating and copying temporaries.
-     */
-    [[nodiscard]] auto eq_ignore_ascii_case(const str& s) const noexcept -> bool
-    {
-        constexpr std::uint8_t ASCII_ignore_case[] {
-            0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25,
-            26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49,
-            50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 97, 98, 99, 100, 101, 102, 103,
-            104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121,
-            122, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109,
-            110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127
-        };
+                out += 4;
+                i += 4;
+                continue;
+            }
 
-        if (this->size() != s.size())
-        {
-            return false;
-        }
+            std::uint32_t cp = units[i];
+            i += 1;
 
-        for (size_t i = 0; i < this->size(); i += 1)
-        {
-            if (this->m_data[i] != s.m_data[i])
+            if (is_surrogate(cp))
             {
-                if (static_cast<std::uint8_t>(this->m_data[i]) < 128 && static_cast<std::uint8_t>(s.m_data[i]) < 128)
+                if (is_high_surrogate(cp) && i < units.size() && is_low_surrogate(units[i]))
                 {
-                    if (ASCII_ignore_case[static_cast<std::uint8_t>(this->m_data[i])] != ASCII_ignore_case[static_cast<std::uint8_t>(s.m_data[i])])
-                    {
-                        return false;
-                    }
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (std::uint32_t(units[i]) - 0xDC00);
+                    i += 1;
                 }
                 else
                 {
-                    return false;
+                    cp = 0xFFFD;
                 }
             }
+
+            out = encode_utf8(cp, out);
         }
 
-        return true;
+        return out;
     }
 
     /**
-     * @brief Creates a new String by repeating a string n times.
-     * @param n The number of times to repeat the string
-     * @note Panics if the capacity overflows.
+     * @brief Returns the length in bytes of the UTF-8 encoding of Latin-1 text
      */
-    template<typename Alloc = std::allocator<std::byte>>
-    constexpr auto repeat(size_t n) const -> raw::String<Alloc>
+    [[nodiscard]] inline auto utf8_len_of_latin1(std::string_view bytes) noexcept -> size_t
     {
-        if (n == 0 || this->m_len == 0)
-        {
-            return raw::String<Alloc>();
-        }
+        const auto data = reinterpret_cast<const std::byte*>(bytes.data());
+        size_t len = bytes.size();
+        size_t i = 0;
 
-        if (n > std::numeric_limits<size_t>::max() / this->m_len)
+        // Every byte above 0x7F takes 2 bytes in UTF-8
+        for (; i + 8 <= bytes.size(); i += 8)
         {
-            panic("Repeat times overflow");
+            len += size_t(std::popcount(swar::load(data + i) & swar::HI));
         }
 
-        raw::String<Alloc> string = raw::String<Alloc>();
-        string.reserve(this->m_len * n);
-        std::byte* ptr = string.data();
-
-        for (size_t i = 0; i < n; i += 1)
+        for (; i < bytes.size(); i++)
         {
-            std::memcpy(ptr + i * this->m_len, this->m_data, this->m_len);
+            len += std::to_integer<std::uint8_t>(data[i]) >> 7;
         }
-        string.m_len = n * this->m_len;
-        string.m_data[string.m_len] = std::byte{0};
 
-        return string;
+        return len;
     }
 
     /**
-     * @brief Returns the length of the string in bytes
+     * @brief Writes the UTF-8 encoding of Latin-1 text and returns the end of the written bytes
      */
-    [[nodiscard]] constexpr auto size() const noexcept -> size_t
+    inline auto latin1_to_utf8(std::string_view bytes, std::byte* out) noexcept -> std::byte*
     {
-        return this->m_len;
-    }
+        const auto data = reinterpret_cast<const std::byte*>(bytes.data());
+        size_t i = 0;
 
-    /**
-     * @brief Returns a sub str of the given range
-     * @param from the sub str beginning index
-     * @param to the sub str ending index (inclusive)
-     * @note Panics
-        - If `from` or `to` exceeded str's length
-        - If `to` is greater than `from`
-     */
-    [[nodiscard]] constexpr auto slice(size_t from, size_t to) const noexcept -> str
-    {
-        if (from > this->m_len || to > this->m_len || std::min(from, to) > this->m_len)
+        while (i < bytes.size())
         {
-            panic("Invalid parameter(s) while calling str::slice, from: {}, to: {}, size: {}", from, to, this->m_len);
-        }
+            if (i + 8 <= bytes.size() && !swar::has_non_ascii(swar::load(data + i)))
+            {
+                std::memcpy(out, data + i, 8);
+                out += 8;
+                i += 8;
+                continue;
+            }
 
-        const auto s = str::from_bytes_unchecked(this->m_data + from, to - from);
-        if (!is_valid_utf8(s.m_data, s.m_len))
-        {
-            panic("Invalid UTF-8 sequence while calling str::slice");
+            out = encode_utf8(std::to_integer<std::uint32_t>(data[i]), out);
+            i += 1;
         }
 
-        return s;
+        return out;
     }
 
     /**
-     * @brief Returns a sub str of the given range
-     * @see str::slice(size_t, size_t) overload for details
+     * @brief Measures the UTF-8 encoding of UTF-32 text
+     * @return The length in bytes and the index of the first value that is not a Unicode scalar value, or cps.size() if
+     *         there is none. Measuring stops at that value.
      */
-    [[nodiscard]] constexpr auto slice(size_t from) const noexcept -> str
+    [[nodiscard]] inline auto utf8_len_of_utf32(std::u32string_view cps) noexcept -> std::pair<size_t, size_t>
     {
-        return this->slice(from, this->m_len);
-    }
+        size_t len = 0;
 
-    /**
-     * @brief Checks if this string starts with the given pattern
-     * @param pattern The pattern to check for
-     * @return true if this string starts with the pattern
-     */
-    [[nodiscard]] constexpr auto starts_with(const str& pattern) const noexcept -> bool
-    {
-        if (pattern.m_len > this->m_len)
+        for (size_t i = 0; i < cps.size(); i++)
         {
-            return false;
-        }
+            if (!is_scalar_value(cps[i]))
+            {
+                return std::pair(len, i);
+            }
 
-        if (pattern.m_len == 0)
-        {
-            return true;
+            len += utf8_width(cps[i]);
         }
 
-        return std::equal(this->m_data, this->m_data + pattern.m_len, pattern.m_data);
+        return std::pair(len, cps.size());
     }
 
     /**
-     * @brief Checks if this string ends with the given pattern
-     * @param pattern The pattern to check for
-     * @return true if this string ends with the pattern
+     * @brief Writes the UTF-8 encoding of UTF-32 text made of Unicode scalar values and returns the end of the written bytes
      */
-    [[nodiscard]] constexpr auto ends_with(const str& pattern) const noexcept -> bool
+    inline auto utf32_to_utf8(std::u32string_view cps, std::byte* out) noexcept -> std::byte*
     {
-        if (pattern.m_len > this->m_len)
-        {
-            return false;
-        }
-
-        if (pattern.m_len == 0)
+        for (const auto cp : cps)
         {
-            return true;
+            out = encode_utf8(cp, out);
         }
 
-        return std::equal(
-            this->m_data + (this->m_len - pattern.m_len),
-            this->m_data + this->m_len,
-            pattern.m_data
-        );
+        return out;
     }
 
     /**
-     * @brief Converts the String to a std::string
-     * @return A std::string containing the String's contents
+     * @brief Returns the number of UTF-16 code units needed to encode valid UTF-8 text
      */
-    [[nodiscard]] constexpr auto to_std_string() const -> std::string
+    [[nodiscard]] inline auto utf16_len_of_utf8(const std::byte* data, size_t len) noexcept -> size_t
     {
-        return std::string(std::bit_cast<const char*>(this->m_data), this->m_len);
-    }
+        // Every char takes one code unit and chars outside the BMP take one more, so count the bytes that are not
+        // continuation bytes (10xxxxxx) plus the lead bytes of 4 byte sequences (11110xxx).
+        // Shifting left moves bits 6 to 4 of each byte onto its high bit, the carries into the next byte are masked out.
+        size_t count = len;
+        size_t i = 0;
 
-    /**
-     * @brief Returns the byte index of the first character that matches the pattern
-     * @param pattern The pattern to search for
-     * @return Option containing the byte index of the first match, or None if not found
-     */
-    [[nodiscard]] constexpr auto find(const str& pattern) const noexcept -> Option<size_t>
-    {
-        if (pattern.m_len > this->m_len || pattern.m_len == 0)
+        for (; i + 8 <= len; i += 8)
         {
-            return None{};
-        }
-
-        // Create spans for the current string and pattern
-        std::span<const std::byte> haystack(this->m_data, this->m_len);
-        std::span<const std::byte> needle(pattern.m_data, pattern.m_len);
+            const auto word = swar::load(data + i);
+            const auto continuation = word & ~(word << 1) & swar::HI;
+            const auto lead4 = word & (word << 1) & (word << 2) & (word << 3) & swar::HI;
 
-        // Use std::ranges::search to find the pattern
-        auto result = std::ranges::search(haystack, needle);
+            count -= size_t(std::popcount(continuation));
+            count += size_t(std::popcount(lead4));
+        }
 
-        if (result.empty())
+        for (; i < len; i++)
         {
-            return None{};
+            const auto byte = std::to_integer<std::uint8_t>(data[i]);
+            count -= (byte & 0xC0) == 0x80 ? 1 : 0;
+            count += byte >= 0xF0 ? 1 : 0;
         }
 
-        // Calculate the byte offset from the start of the string
-        return size_t(std::distance(haystack.begin(), result.begin()));
+        return count;
     }
 
     /**
-     * @brief Returns the byte index of the first character that matches the pattern
-     * @param pattern The pattern to search for
-     * @return Option containing the byte index of the first match, or None if not found
+     * @brief Writes the UTF-16 encoding of valid UTF-8 text and returns the end of the written code units
      */
-    [[nodiscard]] constexpr auto find(const char* pattern) const noexcept -> Option<size_t>
+    inline auto utf8_to_utf16(const std::byte* data, size_t len, char16_t* out) noexcept -> char16_t*
     {
-        return this->find(str::from(pattern).expect("Invalid UTF-8 sequence while calling str::find#pattern"));
-    }
+        const auto continuation = [data](size_t i) { return std::to_integer<std::uint32_t>(data[i]) & 0x3F; };
+        size_t i = 0;
 
-    /**
-     * @brief Checks if all characters in this string are within the ASCII range.
-     */
-    [[nodiscard]] constexpr auto is_ascii() const noexcept -> bool
-    {
-        for (size_t i = 0; i < this->m_len; i++)
+        while (i < len)
         {
-            if (static_cast<std::uint8_t>(this->m_data[i]) > 127)
+            if (i + 8 <= len && !swar::has_non_ascii(swar::load(data + i)))
             {
-                return false;
-            }
-        }
+                for (size_t k = 0; k < 8; k++)
+                {
+                    out[k] = char16_t(std::to_integer<std::uint8_t>(data[i + k]));
+                }
 
-        return true;
-    }
+                out += 8;
+                i += 8;
+                continue;
+            }
 
-    /**
-     * @brief Parses this string into a numeric type
-     * @tparam T The numeric type to parse into
-     * @return A Result containing either the parsed value or a std::from_chars_result
-     * @note This function only works with numeric types (integral and floating-point)
-     */
-    template<typename T>
-        requires (std::integral<T> || std::floating_point<T>)
-    [[nodiscard]] constexpr auto parse() const noexcept -> Result<T, std::from_chars_result>
-    {
-        if (this->m_len == 0)
-        {
-            return std::from_chars_result{reinterpret_cast<const char*>(this->m_data), std::errc::invalid_argument};
-        }
+            const auto lead = std::to_integer<std::uint32_t>(data[i]);
+            std::uint32_t cp;
 
-        T value;
-        auto result = std::from_chars(
-            reinterpret_cast<const char*>(this->m_data),
-            reinterpret_cast<const char*>(this->m_data + this->m_len),
-            value
-        );
+            if (lead < 0x80)
+            {
+                cp = lead;
+                i += 1;
+            }
+            else if (lead < 0xE0)
+            {
+                cp = ((lead & 0x1F) << 6) | continuation(i + 1);
+                i += 2;
+            }
+            else if (lead < 0xF0)
+            {
+                cp = ((lead & 0x0F) << 12) | (continuation(i + 1) << 6) | continuation(i + 2);
+                i += 3;
+            }
+            else
+            {
+                cp = ((lead & 0x07) << 18) | (continuation(i + 1) << 12) | (continuation(i + 2) << 6) | continuation(i + 3);
+                i += 4;
+            }
 
-        if (result.ec == std::errc{})
-        {
-            if (result.ptr == reinterpret_cast<const char*>(this->m_data + this->m_len))
+            if (cp < 0x10000)
             {
-                return value;
+                *out++ = char16_t(cp);
             }
             else
             {
-                result.ec = std::errc::invalid_argument;
-                return result;
+                out[0] = char16_t(0xD800 + ((cp - 0x10000) >> 10));
+                out[1] = char16_t(0xDC00 + ((cp - 0x10000) & 0x3FF));
+                out += 2;
             }
         }
 
-        return result;
+        return out;
     }
+}
 
+/**
+ * @brief The precomputed tables of the Two-Way string matching algorithm (Crochemore and Perrin) for one needle.
+ * Searching takes linear time and constant extra space, and the bad byte shift table skips most of the haystack
+ * when the needle is long or contains uncommon bytes.
+ */
+struct TwoWay
+{
     /**
-     * @brief Replaces all matches of a pattern with another str.
-     * replace creates a new String, and copies the data from this str into it.
-     * While doing so, it attempts to find matches of a pattern. If it finds any, it replaces them with the replacement str.
-     * @param pattern The pattern to search for
-     * @param replacement
-     * @returns a new String
+     * @brief The index plus one of the last occurrence of each byte in the needle, 0 if the byte does not occur
      */
-    template<typename Alloc = std::allocator<std::byte>>
-    constexpr auto replace(const str& pattern, const str& replacement) const -> raw::String<Alloc>
-    {
-        return this->replace_n<Alloc>(pattern, replacement, std::numeric_limits<size_t>::max());
-    }
+    std::array<size_t, 256> shift{};
 
     /**
-     * @brief Replaces all matches of a pattern with another str.
-     * replace creates a new String, and copies the data from this str into it.
-     * While doing so, it attempts to find matches of a pattern. If it finds any, it replaces them with the replacement str.
-     * @param pattern The pattern to search for
-     * @param replacement
-     * @returns a new String
+     * @brief The last index of the left half of the critical factorization, SIZE_MAX if the left half is empty
      */
-    template<typename Alloc = std::allocator<std::byte>>
-    constexpr auto replace(const char* pattern, const char* replacement) const -> raw::String<Alloc>
-    {
-        return this->replace<Alloc>(str::from(pattern).expect("Invalid UTF-8 sequence while calling String::replace#pattern"),
-            str::from(replacement).expect("Invalid UTF-8 sequence while calling String::replace#replacement"));
-    }
+    size_t critical = 0;
 
     /**
-     * @brief Replaces first N matches of a pattern with another string.
-     * replacen creates a new String, and copies the data from this string slice into it.
-     * While doing so, it attempts to find matches of a pattern. If it finds any, it replaces them with the replacement string slice at most `n` times.
-     * @param pattern
-     * @param replacement
-     * @param n
-     * @returns a new String
+     * @brief The shift after a full match of the right half, the period of the needle if it is periodic
      */
-    template<typename Alloc = std::allocator<std::byte>>
-    constexpr auto replace_n(const str& pattern, const str& replacement, size_t n) const -> raw::String<Alloc>
-    {
-        auto string = raw::String<Alloc>();
+    size_t period = 1;
 
-        if (pattern.empty())
-        {
-            string.push_str(*this);
-            return string;
-        }
+    /**
+     * @brief The length of the prefix known to match after shifting a periodic needle by its period, 0 otherwise
+     */
+    size_t memory = 0;
 
-        // Calculate the maximum possible size needed for the result
-        // This is a worst-case estimate where every character is replaced
-        const auto size_diff = replacement.size() > pattern.size()
-            ? replacement.size() - pattern.size()
-            : 0;
-        size_t max_size = this->m_len + size_diff * std::min(n, this->m_len / pattern.size());
-        string.reserve(max_size);
+    constexpr TwoWay() noexcept = default;
 
-        size_t pos = 0;
-        size_t count = 0;
+    TwoWay(const std::byte* needle, size_t len) noexcept
+    {
+        if (len == 0)
+        {
+            return;
+        }
 
-        while (pos < this->m_len && count < n)
+        for (size_t i = 0; i < len; i += 1)
         {
-            const Option<size_t> found = this->slice(pos).find(pattern);
-            if (found.is_none())
-            {
-                break;
-            }
+            this->shift[std::to_integer<std::uint8_t>(needle[i])] = i + 1;
+        }
 
-            const auto found_idx = found.unwrap() + pos;
-            // Copy the part before the pattern
-            string.push_str_unchecked(str::from_bytes_unchecked(this->m_data + pos, found_idx - pos));
-            // Copy the replacement
-            string.push_str_unchecked(replacement);
+        // The critical factorization is the later of the two maximal suffixes, under opposite byte orderings
+        const auto [critical_less, period_less] = TwoWay::maximal_suffix(needle, len, std::less<>());
+        const auto [critical_greater, period_greater] = TwoWay::maximal_suffix(needle, len, std::greater<>());
 
-            // Move to the next position after the pattern
-            pos = found_idx + pattern.size();
-            count++;
+        if (critical_greater + 1 > critical_less + 1)
+        {
+            this->critical = critical_greater;
+            this->period = period_greater;
         }
-
-        // Copy the remaining part of the string
-        if (pos < this->m_len)
+        else
         {
-            string.push_str_unchecked(str::from_bytes_unchecked(this->m_data + pos, this->m_len - pos));
+            this->critical = critical_less;
+            this->period = period_less;
         }
 
-        return string;
+        if (std::memcmp(needle, needle + this->period, this->critical + 1) != 0)
+        {
+            this->memory = 0;
+            this->period = std::max(this->critical, len - this->critical - 1) + 1;
+        }
+        else
+        {
+            this->memory = len - this->period;
+        }
     }
 
     /**
-     * @brief Returns the byte index for the first character of the last match of the pattern in this str slice.
-     * @param pattern The pattern to search for
-     * @returns `None` if the pattern doesn’t match.
+     * @brief Returns the first position at or after from where the needle occurs, or hay_len if there is none.
+     * at(i) returns the byte i of the haystack, which lets the same loop search a reversed haystack.
+     * skip(pos) may move pos forward to the next position that can possibly match, or return hay_len to stop.
      */
-    [[nodiscard]] constexpr auto rfind(const str& pattern) const noexcept -> Option<size_t>
+    template<typename At, typename Skip>
+    [[nodiscard]] auto search(const std::byte* needle, size_t len, size_t hay_len, size_t from, At&& at, Skip&& skip) const noexcept -> size_t
     {
-        if (pattern.m_len > this->m_len || pattern.m_len == 0)
+        size_t pos = from;
+        size_t memory = 0;
+
+        while (pos <= hay_len && hay_len - pos >= len)
         {
-            return None{};
+            if (memory == 0)
+            {
+                pos = skip(pos);
+                if (pos == hay_len)
+                {
+                    break;
+                }
+            }
+
+            // Check the last byte first, and shift the needle to its last occurrence on mismatch
+            const size_t shift = len - this->shift[std::to_integer<std::uint8_t>(at(pos + len - 1))];
+            if (shift != 0)
+            {
+                pos += std::max(shift, memory);
+                memory = 0;
+                continue;
+            }
+
+            // Compare the right half, a mismatch shifts the needle past the compared bytes
+            size_t i = std::max(this->critical + 1, memory);
+            while (i < len && needle[i] == at(pos + i))
+            {
+                i += 1;
+            }
+
+            if (i < len)
+            {
+                pos += i - this->critical;
+                memory = 0;
+                continue;
+            }
+
+            // Compare the left half, the bytes already known to match are skipped
+            i = this->critical + 1;
+            while (i > memory && needle[i - 1] == at(pos + i - 1))
+            {
+                i -= 1;
+            }
+
+            if (i <= memory)
+            {
+                return pos;
+            }
+
+            pos += this->period;
+            memory = this->memory;
         }
 
-        std::span<const std::byte> haystack(this->m_data, this->m_len);
-        std::span<const std::byte> needle(pattern.m_data, pattern.m_len);
+        return hay_len;
+    }
 
-        auto result = std::ranges::find_end(haystack, needle);
+private:
+    template<typename Compare>
+    [[nodiscard]] static auto maximal_suffix(const std::byte* needle, size_t len, Compare compare) noexcept -> std::pair<size_t, size_t>
+    {
+        size_t start = std::numeric_limits<size_t>::max();
+        size_t candidate = 0;
+        size_t offset = 1;
+        size_t period = 1;
 
-        if (result.empty())
+        while (candidate + offset < len)
         {
-            return None{};
+            const auto a = needle[start + offset];
+            const auto b = needle[candidate + offset];
+
+            if (a == b)
+            {
+                if (offset == period)
+                {
+                    candidate += period;
+                    offset = 1;
+                }
+                else
+                {
+                    offset += 1;
+                }
+            }
+            else if (compare(b, a))
+            {
+                candidate += offset;
+                offset = 1;
+                period = candidate - start;
+            }
+            else
+            {
+                start = candidate;
+                candidate += 1;
+                offset = 1;
+                period = 1;
+            }
         }
 
-        return size_t(std::distance(haystack.begin(), result.begin()));
+        return std::pair(start, period);
     }
+};
 
-    /**
-     * @brief Returns the byte index for the first character of the last match of the pattern in this str slice.
-     * @param pattern The pattern to search for
-     * @returns `None` if the pattern doesn’t match.
-     */
-    [[nodiscard]] constexpr auto rfind(const char* pattern) const noexcept -> Option<size_t>
+/**
+ * @brief Estimates how common a byte is in typical text, higher is more common.
+ * Finder runs memchr on the rarest byte of the needle to skip ahead before verifying candidates.
+ */
+[[nodiscard]] constexpr auto byte_rank(std::uint8_t byte) noexcept -> std::uint8_t
+{
+    constexpr std::string_view letters = "etaoinshrdlcumwfgypbvkjxqz";
+
+    if (byte == ' ')
     {
-        return this->rfind(str::from(pattern).expect("Invalid UTF-8 sequence while calling str::rfind#pattern"));
+        return 255;
     }
 
-    /**
-     * @brief If the string starts with the pattern prefix, returns the substring after the prefix, wrapped in Some.
-     * This method removes the prefix exactly once.
-     * @returns A string slice with the prefix removed, if the string does not start with prefix, returns None.
-    */
-    [[nodiscard]] auto strip_prefix(const str& pattern) const noexcept -> Option<str>
+    if (byte >= 'a' && byte <= 'z')
     {
-        if (this->starts_with(pattern))
-        {
-            return this->slice(pattern.size());
-        }
+        return static_cast<std::uint8_t>(250 - letters.find(static_cast<char>(byte)) * 3);
+    }
 
-        return None{};
+    if (byte >= 'A' && byte <= 'Z')
+    {
+        return static_cast<std::uint8_t>(120 - letters.find(static_cast<char>(byte | 0x20)) * 2);
     }
 
-    /**
-     * @brief If the string starts with the pattern suffix, returns the substring before the suffix, wrapped in Some.
-     * This method removes the suffix exactly once.
-     * @returns A str slice with the prefix removed, if the string does not ends with suffix, returns None.
-    */
-    [[nodiscard]] auto strip_suffix(const str& pattern) const noexcept -> Option<str>
+    if (byte >= 0x80 && byte <= 0xBF)
     {
-        if (this->ends_with(pattern))
-        {
-            return this->slice(0, this->m_len - pattern.size());
-        }
+        // UTF-8 continuation bytes are as common as letters in non Latin text
+        return 200;
+    }
 
-        return None{};
+    if (byte == '\n' || byte == '.' || byte == ',' || (byte >= '0' && byte <= '9'))
+    {
+        return 150;
     }
 
-    /**
-     * @brief If the string starts with the pattern prefix, returns the substring after the prefix, wrapped in Some.
-     * This method removes the prefix exactly once.
-     * @returns A string slice with the prefix removed, if the string does not start with prefix, returns None.
-    */
-    [[nodiscard]] auto strip_prefix(const char* pattern) const noexcept -> Option<str>
+    if (byte >= 0xC2 && byte <= 0xF4)
     {
-        return this->strip_prefix(str::from(pattern).expect("Invalid UTF-8 sequence while calling str::strip_prefix#pattern"));
+        return 90;
     }
 
-    /**
-     * @brief If the string starts with the pattern suffix, returns the substring before the suffix, wrapped in Some.
-     * This method removes the suffix exactly once.
-     * @returns A str slice with the prefix removed, if the string does not ends with suffix, returns None.
-    */
-    [[nodiscard]] auto strip_suffix(const char* pattern) const noexcept -> Option<str>
+    if (byte > ' ' && byte < 0x7F)
     {
-        return this->strip_suffix(str::from(pattern).expect("Invalid UTF-8 sequence while calling str::strip_suffix#pattern"));
+        return 60;
     }
 
+    // Other ASCII control characters, and bytes that never occur in UTF-8
+    return byte == '\t' || byte == '\r' ? 100 : 10;
+}
+
+export namespace crab_cpp
+{
+
+struct FromUtf8Error
+{
     /**
-     * @brief Converts ASCII uppercase characters to lowercase
+     * @brief The position where the invalid UTF-8 sequence was found
      */
-    template<typename Alloc = std::allocator<std::byte>>
-    constexpr auto to_ascii_lowercase() const -> raw::String<Alloc>
-    {
-        auto string = raw::String<Alloc>();
-        string.push_str(*this);
-        string.make_ascii_lowercase();
+    size_t pos;
 
-        return string;
-    }
+    /**
+     * @brief Constructs a FromUtf8Error with the given position
+     */
+    constexpr explicit FromUtf8Error(size_t pos) noexcept : pos(pos) {}
+};
 
+/**
+ * @brief The error returned by String::from_utf16
+ */
+struct FromUtf16Error
+{
     /**
-     * @brief Converts ASCII lowercase characters to uppercase
+     * @brief The index of the first unpaired surrogate
      */
-    template<typename Alloc = std::allocator<std::byte>>
-    constexpr auto to_ascii_uppercase() const -> raw::String<Alloc>
-    {
-        auto string = raw::String<Alloc>();
-        string.push_str(*this);
-        string.make_ascii_uppercase();
+    size_t pos;
 
-        return string;
-    }
+    /**
+     * @brief Constructs a FromUtf16Error with the given index
+     */
+    constexpr explicit FromUtf16Error(size_t pos) noexcept : pos(pos) {}
+};
 
+/**
+ * @brief The error returned by String::from_utf32
+ */
+struct FromUtf32Error
+{
     /**
-     * @brief Returns a str with leading and trailing ASCII whitespace removed.
-     * ASCII whitespace refers to U+0020 SPACE, U+0009 HORIZONTAL TAB, U+000A LINE FEED, U+000C FORM FEED, or U+000D CARRIAGE RETURN.
+     * @brief The index of the first value that is not a Unicode scalar value
      */
-    [[nodiscard]] auto trim_ascii() const noexcept -> str
-    {
-        return this->trim_ascii_start().trim_ascii_end();
-    }
+    size_t pos;
 
     /**
-     * @brief Returns a str with leading ASCII whitespace removed.
-     * ASCII whitespace refers to U+0020 SPACE, U+0009 HORIZONTAL TAB, U+000A LINE FEED, U+000C FORM FEED, or U+000D CARRIAGE RETURN.
+     * @brief Constructs a FromUtf32Error with the given index
      */
-    [[nodiscard]] auto trim_ascii_start() const noexcept -> str
-    {
-        if (this->m_len == 0 || this->m_data == nullptr)
-        {
-            return *this;
-        }
+    constexpr explicit FromUtf32Error(size_t pos) noexcept : pos(pos) {}
+};
 
-        size_t i = 0;
-        for (; i < this->m_len; i += 1)
-        {
-            if (this->m_data[i] != std::byte{0x20})
-            {
-                break;
-            }
-        }
+/**
+ * @brief The error returned by str::parse, no larger than the std::errc it carries
+ */
+struct ParseNumberError
+{
+    /**
+     * @brief std::errc::invalid_argument if the string is not a number, std::errc::result_out_of_range if the number
+     *        does not fit in the type
+     */
+    std::errc ec;
 
-        return str(this->m_data + i, this->m_len - i);
-    }
+    /**
+     * @brief Constructs a ParseNumberError with the given error code
+     */
+    constexpr explicit ParseNumberError(std::errc ec) noexcept : ec(ec) {}
+};
 
+/**
+ * @brief The error returned by strings::parse_all
+ */
+struct ParseAllError
+{
     /**
-     * @brief Returns a str with leading ASCII whitespace removed.
-     * ASCII whitespace refers to U+0020 SPACE, U+0009 HORIZONTAL TAB, U+000A LINE FEED, U+000C FORM FEED, or U+000D CARRIAGE RETURN.
+     * @brief The index of the first item that failed to parse
      */
-    [[nodiscard]] auto trim_ascii_end() const noexcept -> str
-    {
-        if (this->m_len == 0 || this->m_data == nullptr)
-        {
-            return *this;
-        }
+    size_t index;
 
-        size_t i = this->m_len - 1;
-        for (; i >= 0; i -= 1)
-        {
-            if (this->m_data[i] != std::byte{0x20})
-            {
-                break;
-            }
-        }
+    /**
+     * @brief Why the item failed to parse, see ParseNumberError::ec
+     */
+    std::errc ec;
 
-        return str(this->m_data, i + 1);
-    }
+    /**
+     * @brief Constructs a ParseAllError with the given index and error code
+     */
+    constexpr explicit ParseAllError(size_t index, std::errc ec) noexcept : index(index), ec(ec) {}
+};
 
+/**
+ * @brief The error returned when appending to a fixed-capacity string would exceed its capacity
+ */
+struct CapacityError
+{
     /**
-     * @brief Returns a string slice with all prefixes that match a pattern repeatedly removed.
-     * @param pattern The pattern to search for
-    */
-    [[nodiscard]] auto trim_start_matches(const str& pattern) const noexcept -> str
-    {
-        if (this->m_len == 0 || this->m_data == nullptr || pattern.m_len == 0)
-        {
-            return *this;
-        }
+     * @brief The length the string would have needed
+     */
+    size_t required;
 
-        const std::byte* curr_data = this->m_data;
-        size_t curr_len = this->m_len;
+    /**
+     * @brief The capacity of the string
+     */
+    size_t capacity;
 
-        while (curr_len >= pattern.m_len)
-        {
-            bool matches = std::equal(curr_data, curr_data + pattern.m_len, pattern.m_data);
+    /**
+     * @brief Constructs a CapacityError with the required length and the capacity
+     */
+    constexpr explicit CapacityError(size_t required, size_t capacity) noexcept : required(required), capacity(capacity) {}
+};
 
-            if (!matches)
-            {
-                break;
-            }
+/**
+ * @brief An incremental UTF-8 validator that accepts its input in chunks
+ * @details A sequence cut at the end of a chunk is carried over to the next chunk, and error positions are
+ *          absolute offsets counted from the first byte ever fed. ASCII runs are skipped 8 bytes at a time.
+ */
+struct Utf8Validator
+{
+private:
+    /**
+     * @brief The states of the UTF-8 automaton, see table 3-7 of the Unicode standard
+     */
+    enum State : std::uint8_t
+    {
+        Accept,
+        // Any continuation byte, 1, 2 or 3 left
+        Tail1,
+        Tail2,
+        Tail3,
+        // Restricted second byte after E0, ED, F0 and F4
+        AfterE0,
+        AfterED,
+        AfterF0,
+        AfterF4,
+        Reject,
+    };
 
-            curr_data += pattern.m_len;
-            curr_len -= pattern.m_len;
-        }
+    State m_state = Accept;
+    size_t m_offset = 0;
+    size_t m_seq_start = 0;
 
-        return str(curr_data, curr_len);
+    [[nodiscard]] static constexpr auto in_range(std::uint8_t byte, std::uint8_t low, std::uint8_t high) noexcept -> bool
+    {
+        return byte >= low && byte <= high;
     }
 
-    /**
-     * @brief Returns a string slice with all suffixes that match a pattern repeatedly removed.
-     * @param pattern The pattern to search for
-    */
-    [[nodiscard]] auto trim_end_matches(const str& pattern) const noexcept -> str
+    [[nodiscard]] static constexpr auto transition(State state, std::uint8_t byte) noexcept -> State
     {
-        if (this->m_len == 0 || this->m_data == nullptr || pattern.m_len == 0)
-        {
-            return *this;
-        }
-
-        const std::byte* curr_data = this->m_data;
-        size_t curr_len = this->m_len;
-
-        while (curr_len >= pattern.m_len)
+        switch (state)
         {
-            bool matches = std::equal(curr_data + curr_len - pattern.m_len,
-                                    curr_data + curr_len,
-                                    pattern.m_data);
-
-            if (!matches)
-            {
-                break;
-            }
-
-            curr_len -= pattern.m_len;
+            case Accept:
+                if (byte < 0x80) return Accept;
+                if (in_range(byte, 0xC2, 0xDF)) return Tail1;
+                if (byte == 0xE0) return AfterE0;
+                if (byte == 0xED) return AfterED;
+                if (in_range(byte, 0xE1, 0xEF)) return Tail2;
+                if (byte == 0xF0) return AfterF0;
+                if (byte == 0xF4) return AfterF4;
+                if (in_range(byte, 0xF1, 0xF3)) return Tail3;
+                return Reject;
+
+            case Tail1: return in_range(byte, 0x80, 0xBF) ? Accept : Reject;
+            case Tail2: return in_range(byte, 0x80, 0xBF) ? Tail1 : Reject;
+            case Tail3: return in_range(byte, 0x80, 0xBF) ? Tail2 : Reject;
+            case AfterE0: return in_range(byte, 0xA0, 0xBF) ? Tail1 : Reject;
+            case AfterED: return in_range(byte, 0x80, 0x9F) ? Tail1 : Reject;
+            case AfterF0: return in_range(byte, 0x90, 0xBF) ? Tail2 : Reject;
+            case AfterF4: return in_range(byte, 0x80, 0x8F) ? Tail2 : Reject;
+            case Reject: return Reject;
         }
 
-        return str(curr_data, curr_len);
+        return Reject;
     }
 
-// iterators
-private:
-    struct Lines
+public:
+    constexpr Utf8Validator() noexcept = default;
+
+    /**
+     * @brief Validates the next chunk of input
+     * @param chunk The bytes following the previously fed ones
+     * @return The total number of bytes validated so far that end on a char boundary,
+     *         or a FromUtf8Error with the absolute position of the first invalid sequence
+     */
+    constexpr auto feed(std::span<const std::byte> chunk) noexcept -> Result<size_t, FromUtf8Error>
     {
-        struct LinesIter
+        if (this->m_state == Reject)
         {
-            using iterator_category = std::forward_iterator_tag;
-            using value_type = plain_str;
-            using difference_type = std::ptrdiff_t;
-            using pointer = plain_str*;
-            using reference = plain_str&;
-
-            const str* s = nullptr;
-            plain_str span;
-            uint32_t skip = 0;
-
-            constexpr explicit LinesIter() noexcept {}
-
-            constexpr explicit LinesIter(const str* s) noexcept : s(s)
-            {
-                if (s != nullptr)
-                {
-                    // Initialize the first line
-                    auto bytes = s->as_bytes();
-                    size_t pos = 0;
-
-                    // Find the first line ending
-                    while (pos < bytes.size())
-                    {
-                        size_t start = 0;
-                        if (bytes[pos] == std::byte{'\n'})
-                        {
-                            span = plain_str(bytes.data() + start, pos - start);
-                            pos += 1; // Skip \n
-                            skip = 1;
-
-                            break;
-                        }
-
-                        if (bytes[pos] == std::byte{'\r'} && pos + 1 < bytes.size() && bytes[pos + 1] == std::byte{'\n'})
-                        {
-                            span = plain_str(bytes.data() + start, pos - start);
-                            pos += 2; // Skip \r\n
-                            skip = 2;
-
-                            break;
-                        }
-                        pos++;
-                    }
-
-                    // If no line ending found, take the whole string
-                    if (pos >= bytes.size())
-                    {
-                        span = plain_str(bytes.data(), bytes.size());
-                        pos = bytes.size();
-                    }
-                }
-            }
-
-            [[nodiscard]] constexpr auto operator*() const noexcept -> const plain_str&
-            {
-                return span;
-            }
+            return FromUtf8Error(this->m_seq_start);
+        }
 
-            [[nodiscard]] constexpr auto operator->() const noexcept -> const plain_str*
-            {
-                return &span;
-            }
+        const std::byte* data = chunk.data();
+        const size_t len = chunk.size();
+        size_t pos = 0;
 
-            constexpr auto operator++() noexcept -> LinesIter&
+        while (pos < len)
+        {
+            if (this->m_state == Accept)
             {
-                if (this->s == nullptr)
-                {
-                    return *this;
-                }
-
-                auto bytes = this->s->as_bytes();
-                size_t start = span.data - bytes.data() + this->span.len + this->skip;
-
-                // If we're at or past the end, mark as finished
-                if (start >= bytes.size())
+                while (pos + 8 <= len && !swar::has_non_ascii(swar::load(data + pos)))
                 {
-                    this->s = nullptr;
-                    span = plain_str(nullptr, 0);
-                    return *this;
+                    pos += 8;
                 }
 
-                // Find the next line ending
-                size_t pos = start;
-                while (pos < bytes.size())
+                if (pos >= len)
                 {
-                    if (bytes[pos] == std::byte{'\n'})
-                    {
-                        span = plain_str(bytes.data() + start, pos - start);
-                        this->skip = 1;
-                        break;
-                    }
-                    else if (bytes[pos] == std::byte{'\r'} && pos + 1 < bytes.size() && bytes[pos + 1] == std::byte{'\n'})
-                    {
-                        span = plain_str(bytes.data() + start, pos - start);
-                        this->skip = 2;
-                        break;
-                    }
-                    pos++;
+                    break;
                 }
 
-                // If no line ending found, take the rest of the string
-                if (pos >= bytes.size())
+                if (static_cast<std::uint8_t>(data[pos]) < 0x80)
                 {
-                    span = plain_str(bytes.data() + start, bytes.size() - start);
+                    pos += 1;
+                    continue;
                 }
 
-                return *this;
-            }
-
-            constexpr auto operator++(int) noexcept -> LinesIter
-            {
-                LinesIter temp = *this;
-                ++(*this);
-                return temp;
+                this->m_seq_start = this->m_offset + pos;
             }
 
-            [[nodiscard]] constexpr auto operator==(const LinesIter& other) const noexcept -> bool
+            this->m_state = Utf8Validator::transition(this->m_state, static_cast<std::uint8_t>(data[pos]));
+            if (this->m_state == Reject)
             {
-                return this->s == other.s;
+                this->m_offset += pos;
+                return FromUtf8Error(this->m_seq_start);
             }
-        };
-
-    public:
-        const str& s;
+            pos += 1;
+        }
 
-    public:
-        constexpr explicit Lines(const str& s) noexcept : s(s) {}
+        this->m_offset += len;
+        return this->valid_up_to();
+    }
 
-    public:
-        [[nodiscard]] constexpr auto begin() const noexcept -> LinesIter
+    /**
+     * @brief Ends the input
+     * @return The total number of bytes fed, or a FromUtf8Error if the input is invalid or ends in the middle of a sequence
+     */
+    [[nodiscard]] constexpr auto finish() const noexcept -> Result<size_t, FromUtf8Error>
+    {
+        if (this->m_state != Accept)
         {
-            return LinesIter(&this->s);
+            return FromUtf8Error(this->m_seq_start);
         }
 
-        [[nodiscard]] constexpr auto end() const noexcept -> LinesIter
-        {
-            return LinesIter(nullptr);
-        }
-    };
+        return this->m_offset;
+    }
 
-    struct Matches
+    /**
+     * @brief Returns true if all the input fed so far is valid and ends on a char boundary
+     */
+    [[nodiscard]] constexpr auto is_complete() const noexcept -> bool
     {
-        struct MatchesIter
-        {
-            using iterator_category = std::forward_iterator_tag;
-            using difference_type = std::ptrdiff_t;
-            using value_type = size_t;
-            using pointer = const size_t*;
-            using reference = const size_t&;
-
-            const str* s = nullptr;
-            plain_str pattern;
-            size_t match_pos = 0;
-            size_t pos = 0;
+        return this->m_state == Accept;
+    }
 
-            constexpr MatchesIter() noexcept = default;
+    /**
+     * @brief Returns the number of bytes of the incomplete sequence at the end of the input fed so far
+     */
+    [[nodiscard]] constexpr auto pending_len() const noexcept -> size_t
+    {
+        return this->m_state == Accept ? 0 : this->m_offset - this->m_seq_start;
+    }
 
-            constexpr MatchesIter(const str* s, const plain_str& pattern) noexcept : s(s), pattern(pattern)
-            {
-                if (s != nullptr)
-                {
-                    // Find the first match
-                    auto ptr = std::search(s->m_data, s->m_data + s->m_len, pattern.data, pattern.data + pattern.len);
-                    if (ptr != s->m_data + s->m_len && pattern.len > 0)
-                    {
-                        const auto match_pos = ptr - s->m_data;
-                        this->match_pos = match_pos;
-                        this->pos = match_pos + pattern.len;
-                    }
-                    else
-                    {
-                        // No match found, set to end iterator
-                        this->s = nullptr;
-                    }
-                }
-            }
+    /**
+     * @brief Returns the number of bytes fed so far that are valid and end on a char boundary
+     */
+    [[nodiscard]] constexpr auto valid_up_to() const noexcept -> size_t
+    {
+        return this->m_state == Accept ? this->m_offset : this->m_seq_start;
+    }
 
-            [[nodiscard]] constexpr auto operator*() const noexcept -> reference
-            {
-                return this->match_pos;
-            }
+    /**
+     * @brief Resets the validator to its initial state
+     */
+    constexpr auto reset() noexcept -> void
+    {
+        *this = Utf8Validator();
+    }
+};
 
-            [[nodiscard]] constexpr auto operator->() const noexcept -> pointer
-            {
-                return &this->match_pos;
-            }
+/**
+ * @brief Validates if the given string is valid UTF-8
+ * @param str The string to validate
+ * @param len The length of the string in bytes
+ * @return true if the string is valid UTF-8
+ */
+[[nodiscard]] constexpr auto is_valid_utf8(const std::byte* str, size_t len) noexcept -> bool
+{
+    if (str == nullptr || len == 0)
+    {
+        return true;
+    }
 
-            constexpr auto operator++() noexcept -> MatchesIter&
-            {
-                if (this->s == nullptr)
-                {
-                    return *this;
-                }
+    auto validator = Utf8Validator();
+    validator.feed(std::span(str, len));
 
-                // Search for the next match starting from the position after the last match
-                auto ptr = std::search(
-                    this->s->m_data + this->pos,
-                    this->s->m_data + this->s->m_len,
-                    this->pattern.data,
-                    this->pattern.data + this->pattern.len
-                );
+    return validator.is_complete();
+}
 
-                if (ptr != this->s->m_data + this->s->m_len)
-                {
-                    const auto match_pos = ptr - this->s->m_data;
-                    this->match_pos = match_pos;
-                    this->pos = match_pos + this->pattern.len;
-                }
-                else
-                {
-                    // No more matches, set to end iterator
-                    this->s = nullptr;
-                }
+[[nodiscard]] constexpr auto is_valid_utf8(const char* str, size_t len) noexcept -> bool
+{
+    return is_valid_utf8(std::bit_cast<const std::byte*>(str), len);
+}
 
-                return *this;
-            }
+/**
+ * @brief A class representing a Unicode scalar value
+ */
+struct Char
+{
+private:
+    std::uint32_t m_value = 0;
 
-            constexpr auto operator++(int) noexcept -> MatchesIter
-            {
+public:
+    /**
+     * @brief Default constructor
+     */
+    constexpr explicit Char() noexcept = default;
+
+    /**
+     * @brief Constructs a Char from a Unicode scalar value
+     * @param value The Unicode scalar value
+     * @note Panics If the value is not a valid Unicode scalar value
+     */
+    constexpr explicit Char(std::uint32_t value) : m_value(value)
+    {
+        if (!is_valid_scalar_value(value))
+        {
+            panic("Invalid Unicode scalar value");
+        }
+    }
+
+private:
+    /**
+     * @param value The value to check
+     * @return true if the value is a valid Unicode scalar value
+     */
+    [[nodiscard]] static constexpr auto is_valid_scalar_value(std::uint32_t value) noexcept -> bool
+    {
+        // Unicode scalar values are in the range [0, 0x10FFFF] excluding surrogate pairs
+        return value <= 0x10FFFF && (value < 0xD800 || value > 0xDFFF);
+    }
+
+public:
+    /**
+     * @return The Unicode scalar value
+     */
+    [[nodiscard]] constexpr auto code_point() const noexcept -> std::uint32_t
+    {
+        return this->m_value;
+    }
+
+    /**
+     * @return true if this char is an ASCII character
+     */
+    [[nodiscard]] constexpr auto is_ascii() const noexcept -> bool
+    {
+        return this->m_value <= 0x7F;
+    }
+
+    /**
+     * @return true if this char is an ASCII alphabetic character
+     */
+    [[nodiscard]] constexpr auto is_ascii_alphabetic() const noexcept -> bool
+    {
+        return (this->m_value >= static_cast<std::uint32_t>('a') && this->m_value <= static_cast<std::uint32_t>('z')) ||
+               (this->m_value >= static_cast<std::uint32_t>('A') && this->m_value <= static_cast<std::uint32_t>('Z'));
+    }
+
+    /**
+     * @return true if this char is an ASCII alphanumeric character
+     */
+    [[nodiscard]] constexpr auto is_ascii_alphanumeric() const noexcept -> bool
+    {
+        return (this->m_value >= static_cast<std::uint32_t>('0') && this->m_value <= static_cast<std::uint32_t>('9')) ||
+               (this->m_value >= static_cast<std::uint32_t>('a') && this->m_value <= static_cast<std::uint32_t>('z')) ||
+               (this->m_value >= static_cast<std::uint32_t>('A') && this->m_value <= static_cast<std::uint32_t>('Z'));
+    }
+
+    /**
+     * @return true if this char is an ASCII lowercase character
+     */
+    [[nodiscard]] constexpr auto is_ascii_lowercase() const noexcept -> bool
+    {
+        return this->m_value >= static_cast<std::uint32_t>('a') && this->m_value <= static_cast<std::uint32_t>('z');
+    }
+
+    /**
+     * @brief Returns true if this char is an ASCII uppercase character
+     * @return true if this char is an ASCII uppercase character
+     */
+    [[nodiscard]] constexpr auto is_ascii_uppercase() const noexcept -> bool
+    {
+        return this->m_value >= static_cast<std::uint32_t>('A') && this->m_value <= static_cast<std::uint32_t>('Z');
+    }
+
+    /**
+     * @details Checks if the value is an ASCII control character: U+0000 NUL ..= U+001F UNIT SEPARATOR, or U+007F DELETE.
+     *          Note that most ASCII whitespace characters are control characters, but SPACE is not.
+     * @return true if this char is an ASCII control character
+     */
+    [[nodiscard]] constexpr auto is_ascii_control() const noexcept -> bool
+    {
+        return (this->m_value <= 0x1F) || (this->m_value == 0x7F);
+    }
+
+    /**
+     * @details Checks if the value is an ASCII whitespace character:
+     *          - U+0020 SPACE
+     *          - U+0009 HORIZONTAL TAB
+     *          - U+000A LINE FEED
+     *          - U+000C FORM FEED
+     *          - U+000D CARRIAGE RETURN
+     * @return true if this char is an ASCII whitespace character
+     */
+    [[nodiscard]] constexpr auto is_ascii_whitespace() const noexcept -> bool
+    {
+        return (this->m_value == 0x20) || // SPACE
+               (this->m_value == 0x09) || // HORIZONTAL TAB
+               (this->m_value == 0x0A) || // LINE FEED
+               (this->m_value == 0x0C) || // FORM FEED
+               (this->m_value == 0x0D);   // CARRIAGE RETURN
+    }
+
+    /**
+     * @brief Checks if the value is an ASCII decimal digit: U+0030 '0' ..= U+0039 '9'.
+     */
+    [[nodiscard]] constexpr auto is_ascii_digit() const noexcept -> bool
+    {
+        return this->m_value >= static_cast<std::uint32_t>('0') && this->m_value <= static_cast<std::uint32_t>('9');
+    }
+
+    /**
+     * @brief Checks if the value is an ASCII hexadecimal digit: U+0030 '0' ..= U+0039 '9', U+0041 'A' ..= U+0046 'F', or U+0061 'a' ..= U+0066 'f'.
+     */
+    [[nodiscard]] constexpr auto is_ascii_hexdigit() const noexcept -> bool
+    {
+        return this->is_ascii_digit() ||
+               (this->m_value >= static_cast<std::uint32_t>('A') && this->m_value <= static_cast<std::uint32_t>('F')) ||
+               (this->m_value >= static_cast<std::uint32_t>('a') && this->m_value <= static_cast<std::uint32_t>('f'));
+    }
+
+// operators
+public:
+    constexpr auto operator==(const Char& other) const noexcept -> bool = default;
+};
+
+struct CharClass;
+
+/**
+ * @brief A std::array of char or Char, used as a pattern that matches any of its elements
+ */
+template<typename P>
+concept CharSet = requires { std::tuple_size<P>::value; } &&
+    (std::same_as<P, std::array<char, std::tuple_size<P>::value>> || std::same_as<P, std::array<Char, std::tuple_size<P>::value>>);
+
+/**
+ * @brief A pattern that matches a single Unicode scalar value at a time, accepted by the str search methods
+ * @details One of:
+ *          - char, matching the Unicode scalar value of the same number, like Rust's u8 as char
+ *          - Char
+ *          - a CharSet, matching any of its elements
+ *          - a CharClass, matching any of its chars
+ *          - a predicate invocable with Char, such as &Char::is_ascii_digit
+ *          Patterns spanning several chars are passed as str instead.
+ */
+template<typename P>
+concept Pattern = std::same_as<P, char> || std::same_as<P, Char> || CharSet<P> || std::same_as<P, CharClass> || std::predicate<const P&, Char>;
+
+namespace raw
+{
+
+template<typename Alloc>
+struct String;
+
+}
+
+template<typename Alloc>
+struct Cow;
+
+struct Finder;
+struct FinderRev;
+struct FinderMatches;
+struct FinderSplit;
+
+/**
+ * @brief The Unicode normalization forms, see https://unicode.org/reports/tr15/
+ */
+enum class NormalizationForm
+{
+    /**
+     * @brief Canonical decomposition followed by canonical composition
+     */
+    NFC,
+
+    /**
+     * @brief Canonical decomposition
+     */
+    NFD,
+
+    /**
+     * @brief Compatibility decomposition followed by canonical composition
+     */
+    NFKC,
+
+    /**
+     * @brief Compatibility decomposition
+     */
+    NFKD,
+};
+
+struct str
+{
+    using pointer = const std::byte*;
+
+private:
+    pointer m_data;
+    size_t m_len;
+
+    /**
+     * @brief Private constructor for internal use
+     */
+    constexpr str(pointer data, size_t len) noexcept : m_data(data), m_len(len) {}
+
+public:
+    /**
+     * @brief Default constructor
+     */
+    constexpr str() noexcept : m_data(nullptr), m_len(0) {}
+
+    /**
+     * @brief Constructs a str from a plain_str
+     * @param s The plain_str to construct from
+     */
+    constexpr str(const plain_str& s) noexcept : m_data(s.data), m_len(s.len) {}
+
+public:
+    [[nodiscard]] constexpr auto begin() const noexcept -> const std::byte*
+    {
+        return std::bit_cast<const std::byte*>(this->m_data);
+    }
+
+    [[nodiscard]] constexpr auto end() const noexcept -> const std::byte*
+    {
+        return std::bit_cast<const std::byte*>(this->m_data + this->m_len);
+    }
+
+    /**
+     * @brief Creates a string view from a pointer and length
+     * @param data Pointer to string data
+     * @param len Length of the string
+     * @return A Result containing either a str or a FromUtf8Error
+     */
+    [[nodiscard]] static constexpr auto from_raw_parts(const char* data, size_t len) noexcept -> Result<str, FromUtf8Error>
+    {
+        if (data == nullptr && len > 0)
+        {
+            return FromUtf8Error(0);
+        }
+
+        auto validator = Utf8Validator();
+        validator.feed(std::span(std::bit_cast<pointer>(data), len));
+
+        const auto result = validator.finish();
+        if (result.is_err())
+        {
+            return result.unwrap_err();
+        }
+
+        return str(std::bit_cast<pointer>(data), len);
+    }
+
+    /**
+     * @brief Constructs a str from a pointer and length
+     * @param data Pointer to string data
+     * @param len Length of the string
+     * @return A str containing the string data
+     */
+    [[nodiscard]] static constexpr auto from_bytes_unchecked(pointer data, size_t len) noexcept -> str
+    {
+        return str(data, len);
+    }
+
+    /**
+     * @brief Creates a string view from a null-terminated, UTF-8 encoded C style string
+     * @param data Pointer to null-terminated string
+     * @return A Result containing either a str or a FromUtf8Error
+     */
+    [[nodiscard]] static constexpr auto from(const char* data) noexcept -> Result<str, FromUtf8Error>
+    {
+        return str::from_raw_parts(data, data != nullptr ? std::strlen(data) : 0);
+    }
+
+public:
+    /**
+     * @brief Returns a byte slice of this str's contents
+     * @return A span containing the string's bytes
+     */
+    [[nodiscard]] constexpr auto as_bytes() const noexcept -> std::span<const std::byte>
+    {
+        return std::span(this->m_data, this->m_len);
+    }
+
+    /**
+     * @brief Returns C-style string of this str's contents
+     * @return A span containing the string's bytes
+     */
+    [[nodiscard]] constexpr auto as_raw() const noexcept -> const char*
+    {
+        return std::bit_cast<const char*>(this->m_data);
+    }
+
+    /**
+     * @brief Returns a C-style string of this str's contents
+     * @return A C-style string of this str's contents
+     */
+    [[nodiscard]] constexpr auto c_str() const noexcept -> const char*
+    {
+        return std::bit_cast<const char*>(this->m_data);
+    }
+
+    /**
+     * @brief Checks if this string contains the given pattern
+     * @param pattern The pattern to search for
+     * @return true if this string contains the pattern
+     */
+    [[nodiscard]] constexpr auto contains(const str& pattern) const noexcept -> bool
+    {
+        if (pattern.m_len > this->m_len)
+        {
+            return false;
+        }
+
+        if (pattern.m_len == 0)
+        {
+            return true;
+        }
+
+        // Create spans for the current string and pattern
+        std::span<const std::byte> haystack(this->m_data, this->m_len);
+        std::span<const std::byte> needle(pattern.m_data, pattern.m_len);
+
+        // Use std::ranges::search to find the pattern
+        auto result = std::ranges::search(haystack, needle);
+        return !result.empty();
+    }
+
+    /**
+     * @brief Checks if this string contains a char matching the pattern
+     * @param pattern The pattern to search for
+     * @return true if this string contains a match
+     */
+    template<Pattern P>
+    [[nodiscard]] auto contains(const P& pattern) const noexcept -> bool
+    {
+        return CharMatcher<P>(pattern).find(*this, 0).first != this->m_len;
+    }
+
+    /**
+     * @brief Returns a pointer to the string data
+     */
+    [[nodiscard]] constexpr auto data() const noexcept -> pointer
+    {
+        return this->m_data;
+    }
+
+    /**
+     * @brief Returns if the string is empty
+     */
+    [[nodiscard]] constexpr auto empty() const noexcept -> bool
+    {
+        return this->m_len == 0;
+    }
+
+    /**
+     * @brief Checks that two strings are an ASCII case-insensitive match.
+     * Same as to_ascii_lowercase(a) == to_ascii_lowercase(b), but without allocating and copying temporaries.
+     */
+    [[nodiscard]] auto eq_ignore_ascii_case(const str& s) const noexcept -> bool
+    {
+        constexpr std::uint8_t ASCII_ignore_case[] {
+            0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25,
+            26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49,
+            50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 97, 98, 99, 100, 101, 102, 103,
+            104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121,
+            122, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109,
+            110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127
+        };
+
+        if (this->size() != s.size())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < this->size(); i += 1)
+        {
+            if (this->m_data[i] != s.m_data[i])
+            {
+                if (static_cast<std::uint8_t>(this->m_data[i]) < 128 && static_cast<std::uint8_t>(s.m_data[i]) < 128)
+                {
+                    if (ASCII_ignore_case[static_cast<std::uint8_t>(this->m_data[i])] != ASCII_ignore_case[static_cast<std::uint8_t>(s.m_data[i])])
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Checks that two strings are a Unicode case-insensitive match.
+     * Same as a.case_fold() == b.case_fold(), but without allocating and copying temporaries.
+     * The leading ASCII parts are compared 8 bytes at a time, the rest is folded lazily character by character.
+     */
+    [[nodiscard]] auto eq_ignore_case(const str& s) const noexcept -> bool
+    {
+        const size_t min_len = std::min(this->m_len, s.m_len);
+        size_t pos = 0;
+
+        while (pos + 8 <= min_len)
+        {
+            const auto lhs = swar::load(this->m_data + pos);
+            const auto rhs = swar::load(s.m_data + pos);
+
+            if (swar::has_non_ascii(lhs | rhs))
+            {
+                break;
+            }
+
+            if (swar::to_ascii_lowercase(lhs) != swar::to_ascii_lowercase(rhs))
+            {
+                return false;
+            }
+            pos += 8;
+        }
+
+        for (; pos < min_len; pos += 1)
+        {
+            const auto lhs = static_cast<std::uint8_t>(this->m_data[pos]);
+            const auto rhs = static_cast<std::uint8_t>(s.m_data[pos]);
+
+            if ((lhs | rhs) >= 0x80)
+            {
+                break;
+            }
+
+            if (lhs != rhs && swar::to_ascii_lowercase(lhs) != swar::to_ascii_lowercase(rhs))
+            {
+                return false;
+            }
+        }
+
+        auto lhs = CaseFoldIter(this->m_data + pos, this->m_len - pos);
+        auto rhs = CaseFoldIter(s.m_data + pos, s.m_len - pos);
+        utf8proc_int32_t lhs_cp = 0;
+        utf8proc_int32_t rhs_cp = 0;
+
+        while (true)
+        {
+            const bool lhs_has_next = lhs.next(lhs_cp);
+            const bool rhs_has_next = rhs.next(rhs_cp);
+
+            if (!lhs_has_next || !rhs_has_next)
+            {
+                return lhs_has_next == rhs_has_next;
+            }
+
+            if (lhs_cp != rhs_cp)
+            {
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief Creates a new String by repeating a string n times.
+     * @param n The number of times to repeat the string
+     * @note Panics if the capacity overflows.
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    constexpr auto repeat(size_t n) const -> raw::String<Alloc>
+    {
+        if (n == 0 || this->m_len == 0)
+        {
+            return raw::String<Alloc>();
+        }
+
+        if (n > std::numeric_limits<size_t>::max() / this->m_len)
+        {
+            panic("Repeat times overflow");
+        }
+
+        raw::String<Alloc> string = raw::String<Alloc>();
+        string.reserve(this->m_len * n);
+        std::byte* ptr = string.data();
+
+        for (size_t i = 0; i < n; i += 1)
+        {
+            std::memcpy(ptr + i * this->m_len, this->m_data, this->m_len);
+        }
+        string.m_len = n * this->m_len;
+        string.m_data[string.m_len] = std::byte{0};
+
+        return string;
+    }
+
+    /**
+     * @brief Returns the length of the string in bytes
+     */
+    [[nodiscard]] constexpr auto size() const noexcept -> size_t
+    {
+        return this->m_len;
+    }
+
+    /**
+     * @brief Checks if the byte at the index is the first byte of a char, or the end of the string.
+     * Since a str is always valid UTF-8 this only inspects that one byte.
+     * @param index The byte index to check
+     * @return true if index is 0, the length of the string, or the start of a char
+     */
+    [[nodiscard]] constexpr auto is_char_boundary(size_t index) const noexcept -> bool
+    {
+        if (index == 0 || index == this->m_len)
+        {
+            return true;
+        }
+
+        // Every byte except the UTF-8 continuation bytes 0b10xxxxxx starts a char
+        return index < this->m_len && (std::to_integer<std::uint8_t>(this->m_data[index]) & 0xC0) != 0x80;
+    }
+
+    /**
+     * @brief Returns a sub str of the given range
+     * @param from the sub str beginning index
+     * @param to the sub str ending index (exclusive)
+     * @note Panics
+        - If `from` or `to` exceeded str's length
+        - If `from` is greater than `to`
+        - If `from` or `to` is not on a char boundary
+     */
+    [[nodiscard]] constexpr auto slice(size_t from, size_t to) const noexcept -> str
+    {
+        if (from > this->m_len || to > this->m_len || from > to)
+        {
+            panic("Invalid parameter(s) while calling str::slice, from: {}, to: {}, size: {}", from, to, this->m_len);
+        }
+
+        if (!this->is_char_boundary(from) || !this->is_char_boundary(to))
+        {
+            panic("Invalid UTF-8 sequence while calling str::slice");
+        }
+
+        return str::from_bytes_unchecked(this->m_data + from, to - from);
+    }
+
+    /**
+     * @brief Returns a sub str of the given range without any check
+     * @param from the sub str beginning index
+     * @param to the sub str ending index (exclusive)
+     * @note The behavior is undefined if the range is out of bounds, reversed, or not on char boundaries
+     */
+    [[nodiscard]] constexpr auto slice_unchecked(size_t from, size_t to) const noexcept -> str
+    {
+        return str(this->m_data + from, to - from);
+    }
+
+    /**
+     * @brief Returns a sub str of the given range, or None if slice would panic
+     * @param from the sub str beginning index
+     * @param to the sub str ending index (exclusive)
+     */
+    [[nodiscard]] constexpr auto get(size_t from, size_t to) const noexcept -> Option<str>
+    {
+        if (from > to || to > this->m_len || !this->is_char_boundary(from) || !this->is_char_boundary(to))
+        {
+            return None{};
+        }
+
+        return str(this->m_data + from, to - from);
+    }
+
+    /**
+     * @brief Returns a sub str of the given range
+     * @see str::slice(size_t, size_t) overload for details
+     */
+    [[nodiscard]] constexpr auto slice(size_t from) const noexcept -> str
+    {
+        return this->slice(from, this->m_len);
+    }
+
+    /**
+     * @brief Checks if this string starts with the given pattern
+     * @param pattern The pattern to check for
+     * @return true if this string starts with the pattern
+     */
+    [[nodiscard]] constexpr auto starts_with(const str& pattern) const noexcept -> bool
+    {
+        if (pattern.m_len > this->m_len)
+        {
+            return false;
+        }
+
+        if (pattern.m_len == 0)
+        {
+            return true;
+        }
+
+        return std::equal(this->m_data, this->m_data + pattern.m_len, pattern.m_data);
+    }
+
+    /**
+     * @brief Checks if this string ends with the given pattern
+     * @param pattern The pattern to check for
+     * @return true if this string ends with the pattern
+     */
+    [[nodiscard]] constexpr auto ends_with(const str& pattern) const noexcept -> bool
+    {
+        if (pattern.m_len > this->m_len)
+        {
+            return false;
+        }
+
+        if (pattern.m_len == 0)
+        {
+            return true;
+        }
+
+        return std::equal(
+            this->m_data + (this->m_len - pattern.m_len),
+            this->m_data + this->m_len,
+            pattern.m_data
+        );
+    }
+
+    /**
+     * @brief Checks if the first char of this string matches the pattern
+     * @param pattern The pattern to check for
+     * @return true if this string starts with a match
+     */
+    template<Pattern P>
+    [[nodiscard]] auto starts_with(const P& pattern) const noexcept -> bool
+    {
+        return CharMatcher<P>(pattern).prefix_len(*this) != 0;
+    }
+
+    /**
+     * @brief Checks if the last char of this string matches the pattern
+     * @param pattern The pattern to check for
+     * @return true if this string ends with a match
+     */
+    template<Pattern P>
+    [[nodiscard]] auto ends_with(const P& pattern) const noexcept -> bool
+    {
+        return CharMatcher<P>(pattern).suffix_len(*this) != 0;
+    }
+
+    /**
+     * @brief Converts the String to a std::string
+     * @return A std::string containing the String's contents
+     */
+    [[nodiscard]] constexpr auto to_std_string() const -> std::string
+    {
+        return std::string(std::bit_cast<const char*>(this->m_data), this->m_len);
+    }
+
+    /**
+     * @brief Returns the byte index of the first character that matches the pattern
+     * @param pattern The pattern to search for
+     * @return Option containing the byte index of the first match, or None if not found
+     */
+    [[nodiscard]] constexpr auto find(const str& pattern) const noexcept -> Option<size_t>
+    {
+        if (pattern.m_len > this->m_len || pattern.m_len == 0)
+        {
+            return None{};
+        }
+
+        // Create spans for the current string and pattern
+        std::span<const std::byte> haystack(this->m_data, this->m_len);
+        std::span<const std::byte> needle(pattern.m_data, pattern.m_len);
+
+        // Use std::ranges::search to find the pattern
+        auto result = std::ranges::search(haystack, needle);
+
+        if (result.empty())
+        {
+            return None{};
+        }
+
+        // Calculate the byte offset from the start of the string
+        return size_t(std::distance(haystack.begin(), result.begin()));
+    }
+
+    /**
+     * @brief Returns the byte index of the first character that matches the pattern
+     * @param pattern The pattern to search for
+     * @return Option containing the byte index of the first match, or None if not found
+     */
+    [[nodiscard]] constexpr auto find(const char* pattern) const noexcept -> Option<size_t>
+    {
+        return this->find(str::from(pattern).expect("Invalid UTF-8 sequence while calling str::find#pattern"));
+    }
+
+    /**
+     * @brief Returns the byte index of the first match of a precompiled needle
+     * @param finder The searcher built for the needle
+     * @return Option containing the byte index of the first match, or None if not found
+     */
+    [[nodiscard]] auto find(const Finder& finder) const noexcept -> Option<size_t>;
+
+    /**
+     * @brief Returns the byte index of the first char that is in the set
+     * @param set The chars to search for
+     * @return Option containing the byte index of the first match, or None if not found
+     */
+    [[nodiscard]] auto find_any_of(const CharClass& set) const noexcept -> Option<size_t>;
+
+    /**
+     * @brief Returns the byte index of the first char that is not in the set
+     * @param set The chars to skip
+     * @return Option containing the byte index of the first char outside the set, or None if every char is in the set
+     */
+    [[nodiscard]] auto find_not_of(const CharClass& set) const noexcept -> Option<size_t>;
+
+    /**
+     * @brief Returns the byte index of the first char that matches the pattern
+     * @param pattern The pattern to search for
+     * @return Option containing the byte index of the first match, or None if not found
+     */
+    template<Pattern P>
+    [[nodiscard]] auto find(const P& pattern) const noexcept -> Option<size_t>
+    {
+        const auto pos = CharMatcher<P>(pattern).find(*this, 0).first;
+        if (pos == this->m_len)
+        {
+            return None{};
+        }
+
+        return pos;
+    }
+
+    /**
+     * @brief Checks if all characters in this string are within the ASCII range.
+     */
+    [[nodiscard]] constexpr auto is_ascii() const noexcept -> bool
+    {
+        for (size_t i = 0; i < this->m_len; i++)
+        {
+            if (static_cast<std::uint8_t>(this->m_data[i]) > 127)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Checks if this str is in the given normalization form
+     * @details A single quick check pass decides most inputs, only strings containing characters whose
+     *          status depends on their context (e.g. combining marks for NFC) are normalized and compared.
+     * @tparam Form The normalization form to check against
+     * @tparam Alloc The allocator used when the quick check is inconclusive
+     */
+    template<NormalizationForm Form, typename Alloc = std::allocator<std::byte>>
+    [[nodiscard]] auto is_normalized() const -> bool
+    {
+        switch (this->normalization_quick_check(Form))
+        {
+            case QuickCheck::Yes:
+                return true;
+
+            case QuickCheck::No:
+                return false;
+
+            case QuickCheck::Maybe:
+                return this->normalize_slow<Alloc>(Form) == *this;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Returns this str in the given normalization form as a new String
+     * @details Already normalized input is detected by a quick check pass and copied as is.
+     * @tparam Form The normalization form to convert to
+     */
+    template<NormalizationForm Form, typename Alloc = std::allocator<std::byte>>
+    auto normalize() const -> raw::String<Alloc>
+    {
+        if (this->normalization_quick_check(Form) == QuickCheck::Yes)
+        {
+            return raw::String<Alloc>(*this);
+        }
+
+        return this->normalize_slow<Alloc>(Form);
+    }
+
+    /**
+     * @brief Returns this str in the given normalization form, borrowing this str if it is already normalized
+     * @tparam Form The normalization form to convert to
+     */
+    template<NormalizationForm Form, typename Alloc = std::allocator<std::byte>>
+    auto normalize_cow() const -> Cow<Alloc>
+    {
+        switch (this->normalization_quick_check(Form))
+        {
+            case QuickCheck::Yes:
+                return *this;
+
+            case QuickCheck::No:
+                return this->normalize_slow<Alloc>(Form);
+
+            case QuickCheck::Maybe:
+            {
+                auto string = this->normalize_slow<Alloc>(Form);
+                if (string == *this)
+                {
+                    return *this;
+                }
+
+                return string;
+            }
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Parses this string into a numeric type
+     * @tparam T The numeric type to parse into
+     * @return A Result containing either the parsed value or a ParseNumberError
+     * @note This function only works with numeric types (integral and floating-point). The accepted syntax is the
+     *       one of std::from_chars, and the whole string must be consumed.
+     */
+    template<typename T>
+        requires (std::integral<T> || std::floating_point<T>)
+    [[nodiscard]] constexpr auto parse() const noexcept -> Result<T, ParseNumberError>
+    {
+        if constexpr (std::integral<T> && sizeof(T) <= sizeof(std::uint64_t))
+        {
+            return this->parse_integer<T>();
+        }
+        else
+        {
+            if (this->m_len == 0)
+            {
+                return ParseNumberError(std::errc::invalid_argument);
+            }
+
+            T value;
+            const auto result = std::from_chars(
+                reinterpret_cast<const char*>(this->m_data),
+                reinterpret_cast<const char*>(this->m_data + this->m_len),
+                value
+            );
+
+            if (result.ec != std::errc{})
+            {
+                return ParseNumberError(result.ec);
+            }
+
+            if (result.ptr != reinterpret_cast<const char*>(this->m_data + this->m_len))
+            {
+                return ParseNumberError(std::errc::invalid_argument);
+            }
+
+            return value;
+        }
+    }
+
+    /**
+     * @brief Replaces all matches of a pattern with another str.
+     * replace creates a new String, and copies the data from this str into it.
+     * While doing so, it attempts to find matches of a pattern. If it finds any, it replaces them with the replacement str.
+     * @param pattern The pattern to search for
+     * @param replacement
+     * @returns a new String
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    constexpr auto replace(const str& pattern, const str& replacement) const -> raw::String<Alloc>
+    {
+        return this->replace_n<Alloc>(pattern, replacement, std::numeric_limits<size_t>::max());
+    }
+
+    /**
+     * @brief Replaces all matches of a pattern with another str.
+     * replace creates a new String, and copies the data from this str into it.
+     * While doing so, it attempts to find matches of a pattern. If it finds any, it replaces them with the replacement str.
+     * @param pattern The pattern to search for
+     * @param replacement
+     * @returns a new String
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    constexpr auto replace(const char* pattern, const char* replacement) const -> raw::String<Alloc>
+    {
+        return this->replace<Alloc>(str::from(pattern).expect("Invalid UTF-8 sequence while calling String::replace#pattern"),
+            str::from(replacement).expect("Invalid UTF-8 sequence while calling String::replace#replacement"));
+    }
+
+    /**
+     * @brief Replaces all matches of a precompiled needle with another str.
+     * @param finder The searcher built for the needle
+     * @param replacement
+     * @returns a new String
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    auto replace(const Finder& finder, const str& replacement) const -> raw::String<Alloc>;
+
+    /**
+     * @brief Replaces first N matches of a pattern with another string.
+     * replacen creates a new String, and copies the data from this string slice into it.
+     * While doing so, it attempts to find matches of a pattern. If it finds any, it replaces them with the replacement string slice at most `n` times.
+     * @param pattern
+     * @param replacement
+     * @param n
+     * @returns a new String
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    constexpr auto replace_n(const str& pattern, const str& replacement, size_t n) const -> raw::String<Alloc>
+    {
+        if (pattern.empty())
+        {
+            auto string = raw::String<Alloc>();
+            string.push_str(*this);
+            return string;
+        }
+
+        const Option<size_t> first = n > 0 ? this->find(pattern) : Option<size_t>(None{});
+        return this->replace_n_at<Alloc>(pattern, replacement, n, first.is_some() ? first.unwrap() : this->m_len);
+    }
+
+    /**
+     * @brief Replaces all matches of a pattern with another str, borrowing this str if the pattern doesn't match.
+     * @param pattern The pattern to search for
+     * @param replacement
+     * @returns this str if there is no match, otherwise a new String
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    constexpr auto replace_cow(const str& pattern, const str& replacement) const -> Cow<Alloc>
+    {
+        return this->replace_n_cow<Alloc>(pattern, replacement, std::numeric_limits<size_t>::max());
+    }
+
+    /**
+     * @brief Replaces first N matches of a pattern with another str, borrowing this str if nothing is replaced.
+     * @param pattern
+     * @param replacement
+     * @param n
+     * @returns this str if there is no match or n is 0, otherwise a new String
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    constexpr auto replace_n_cow(const str& pattern, const str& replacement, size_t n) const -> Cow<Alloc>
+    {
+        if (n == 0 || pattern.empty())
+        {
+            return *this;
+        }
+
+        // The first match decides between borrowing and replacing, and replacing starts from it instead of searching again
+        const Option<size_t> first = this->find(pattern);
+        if (first.is_none())
+        {
+            return *this;
+        }
+
+        return this->replace_n_at<Alloc>(pattern, replacement, n, first.unwrap());
+    }
+
+private:
+    /**
+     * @brief The loop of replace_n, starting from the first match already found at byte index first, or m_len if none
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    constexpr auto replace_n_at(const str& pattern, const str& replacement, size_t n, size_t first) const -> raw::String<Alloc>
+    {
+        auto string = raw::String<Alloc>();
+
+        // Calculate the maximum possible size needed for the result
+        // This is a worst-case estimate where every character is replaced
+        const auto size_diff = replacement.size() > pattern.size()
+            ? replacement.size() - pattern.size()
+            : 0;
+        size_t max_size = this->m_len + size_diff * std::min(n, this->m_len / pattern.size());
+        string.reserve(max_size);
+
+        size_t pos = 0;
+        size_t count = 0;
+        size_t found_idx = first;
+
+        while (found_idx < this->m_len && count < n)
+        {
+            // Copy the part before the pattern
+            string.push_str_unchecked(str::from_bytes_unchecked(this->m_data + pos, found_idx - pos));
+            // Copy the replacement
+            string.push_str_unchecked(replacement);
+
+            // Move to the next position after the pattern
+            pos = found_idx + pattern.size();
+            count++;
+
+            const Option<size_t> found = pos < this->m_len && count < n ? this->slice(pos).find(pattern) : Option<size_t>(None{});
+            found_idx = found.is_some() ? found.unwrap() + pos : this->m_len;
+        }
+
+        // Copy the remaining part of the string
+        if (pos < this->m_len)
+        {
+            string.push_str_unchecked(str::from_bytes_unchecked(this->m_data + pos, this->m_len - pos));
+        }
+
+        return string;
+    }
+
+public:
+    /**
+     * @brief Returns the byte index for the first character of the last match of the pattern in this str slice.
+     * @param pattern The pattern to search for
+     * @returns `None` if the pattern doesn’t match.
+     */
+    [[nodiscard]] constexpr auto rfind(const str& pattern) const noexcept -> Option<size_t>
+    {
+        if (pattern.m_len > this->m_len || pattern.m_len == 0)
+        {
+            return None{};
+        }
+
+        std::span<const std::byte> haystack(this->m_data, this->m_len);
+        std::span<const std::byte> needle(pattern.m_data, pattern.m_len);
+
+        auto result = std::ranges::find_end(haystack, needle);
+
+        if (result.empty())
+        {
+            return None{};
+        }
+
+        return size_t(std::distance(haystack.begin(), result.begin()));
+    }
+
+    /**
+     * @brief Returns the byte index for the first character of the last match of the pattern in this str slice.
+     * @param pattern The pattern to search for
+     * @returns `None` if the pattern doesn’t match.
+     */
+    [[nodiscard]] constexpr auto rfind(const char* pattern) const noexcept -> Option<size_t>
+    {
+        return this->rfind(str::from(pattern).expect("Invalid UTF-8 sequence while calling str::rfind#pattern"));
+    }
+
+    /**
+     * @brief Returns the byte index of the last match of a precompiled needle
+     * @param finder The searcher built for the needle
+     * @returns `None` if the needle doesn’t match.
+     */
+    [[nodiscard]] auto rfind(const FinderRev& finder) const noexcept -> Option<size_t>;
+
+    /**
+     * @brief Returns the byte index of the last char that matches the pattern
+     * @param pattern The pattern to search for
+     * @returns `None` if the pattern doesn’t match.
+     */
+    template<Pattern P>
+    [[nodiscard]] auto rfind(const P& pattern) const noexcept -> Option<size_t>
+    {
+        const auto pos = CharMatcher<P>(pattern).rfind(*this).first;
+        if (pos == this->m_len)
+        {
+            return None{};
+        }
+
+        return pos;
+    }
+
+    /**
+     * @brief If the string starts with the pattern prefix, returns the substring after the prefix, wrapped in Some.
+     * This method removes the prefix exactly once.
+     * @returns A string slice with the prefix removed, if the string does not start with prefix, returns None.
+    */
+    [[nodiscard]] auto strip_prefix(const str& pattern) const noexcept -> Option<str>
+    {
+        if (this->starts_with(pattern))
+        {
+            return this->slice(pattern.size());
+        }
+
+        return None{};
+    }
+
+    /**
+     * @brief If the string starts with the pattern suffix, returns the substring before the suffix, wrapped in Some.
+     * This method removes the suffix exactly once.
+     * @returns A str slice with the prefix removed, if the string does not ends with suffix, returns None.
+    */
+    [[nodiscard]] auto strip_suffix(const str& pattern) const noexcept -> Option<str>
+    {
+        if (this->ends_with(pattern))
+        {
+            return this->slice(0, this->m_len - pattern.size());
+        }
+
+        return None{};
+    }
+
+    /**
+     * @brief If the string starts with the pattern prefix, returns the substring after the prefix, wrapped in Some.
+     * This method removes the prefix exactly once.
+     * @returns A string slice with the prefix removed, if the string does not start with prefix, returns None.
+    */
+    [[nodiscard]] auto strip_prefix(const char* pattern) const noexcept -> Option<str>
+    {
+        return this->strip_prefix(str::from(pattern).expect("Invalid UTF-8 sequence while calling str::strip_prefix#pattern"));
+    }
+
+    /**
+     * @brief If the string starts with the pattern suffix, returns the substring before the suffix, wrapped in Some.
+     * This method removes the suffix exactly once.
+     * @returns A str slice with the prefix removed, if the string does not ends with suffix, returns None.
+    */
+    [[nodiscard]] auto strip_suffix(const char* pattern) const noexcept -> Option<str>
+    {
+        return this->strip_suffix(str::from(pattern).expect("Invalid UTF-8 sequence while calling str::strip_suffix#pattern"));
+    }
+
+    /**
+     * @brief Converts ASCII uppercase characters to lowercase
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    constexpr auto to_ascii_lowercase() const -> raw::String<Alloc>
+    {
+        auto string = raw::String<Alloc>();
+        string.push_str(*this);
+        string.make_ascii_lowercase();
+
+        return string;
+    }
+
+    /**
+     * @brief Converts ASCII lowercase characters to uppercase
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    constexpr auto to_ascii_uppercase() const -> raw::String<Alloc>
+    {
+        auto string = raw::String<Alloc>();
+        string.push_str(*this);
+        string.make_ascii_uppercase();
+
+        return string;
+    }
+
+    /**
+     * @brief Returns the lowercase equivalent of this str as a new String.
+     * @details Uses the simple (one to one) Unicode case mapping for each character, ASCII runs are mapped without decoding.
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    auto to_lowercase() const -> raw::String<Alloc>
+    {
+        return this->case_map<Alloc>(CaseMapping::Lower);
+    }
+
+    /**
+     * @brief Returns the uppercase equivalent of this str as a new String.
+     * @details Uses the simple (one to one) Unicode case mapping for each character, ASCII runs are mapped without decoding.
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    auto to_uppercase() const -> raw::String<Alloc>
+    {
+        return this->case_map<Alloc>(CaseMapping::Upper);
+    }
+
+    /**
+     * @brief Returns the case folded equivalent of this str as a new String.
+     * @details Uses the full Unicode case folding, so a character may fold to several characters, e.g. 'ß' folds to "ss".
+     *          Two strings are case-insensitively equal if their case folded forms are equal, see str::eq_ignore_case.
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    auto case_fold() const -> raw::String<Alloc>
+    {
+        return this->case_map<Alloc>(CaseMapping::Fold);
+    }
+
+    /**
+     * @brief Converts ASCII uppercase characters to lowercase, borrowing this str if it has none
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    auto to_ascii_lowercase_cow() const -> Cow<Alloc>
+    {
+        if (this->find_ascii_cased(false) == this->m_len)
+        {
+            return *this;
+        }
+
+        return this->to_ascii_lowercase<Alloc>();
+    }
+
+    /**
+     * @brief Converts ASCII lowercase characters to uppercase, borrowing this str if it has none
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    auto to_ascii_uppercase_cow() const -> Cow<Alloc>
+    {
+        if (this->find_ascii_cased(true) == this->m_len)
+        {
+            return *this;
+        }
+
+        return this->to_ascii_uppercase<Alloc>();
+    }
+
+    /**
+     * @brief Returns the lowercase equivalent of this str, borrowing this str if it is already lowercase
+     * @see str::to_lowercase
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    auto to_lowercase_cow() const -> Cow<Alloc>
+    {
+        return this->case_map_cow<Alloc>(CaseMapping::Lower);
+    }
+
+    /**
+     * @brief Returns the uppercase equivalent of this str, borrowing this str if it is already uppercase
+     * @see str::to_uppercase
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    auto to_uppercase_cow() const -> Cow<Alloc>
+    {
+        return this->case_map_cow<Alloc>(CaseMapping::Upper);
+    }
+
+    /**
+     * @brief Returns the case folded equivalent of this str, borrowing this str if it is already case folded
+     * @see str::case_fold
+     */
+    template<typename Alloc = std::allocator<std::byte>>
+    auto case_fold_cow() const -> Cow<Alloc>
+    {
+        return this->case_map_cow<Alloc>(CaseMapping::Fold);
+    }
+
+    /**
+     * @brief Returns a str with leading and trailing ASCII whitespace removed.
+     * ASCII whitespace refers to U+0020 SPACE, U+0009 HORIZONTAL TAB, U+000A LINE FEED, U+000C FORM FEED, or U+000D CARRIAGE RETURN.
+     */
+    [[nodiscard]] auto trim_ascii() const noexcept -> str
+    {
+        return this->trim_ascii_start().trim_ascii_end();
+    }
+
+    /**
+     * @brief Returns a str with leading ASCII whitespace removed.
+     * ASCII whitespace refers to U+0020 SPACE, U+0009 HORIZONTAL TAB, U+000A LINE FEED, U+000C FORM FEED, or U+000D CARRIAGE RETURN.
+     */
+    [[nodiscard]] auto trim_ascii_start() const noexcept -> str
+    {
+        if (this->m_len == 0 || this->m_data == nullptr)
+        {
+            return *this;
+        }
+
+        size_t i = 0;
+        for (; i < this->m_len; i += 1)
+        {
+            if (this->m_data[i] != std::byte{0x20})
+            {
+                break;
+            }
+        }
+
+        return str(this->m_data + i, this->m_len - i);
+    }
+
+    /**
+     * @brief Returns a str with leading ASCII whitespace removed.
+     * ASCII whitespace refers to U+0020 SPACE, U+0009 HORIZONTAL TAB, U+000A LINE FEED, U+000C FORM FEED, or U+000D CARRIAGE RETURN.
+     */
+    [[nodiscard]] auto trim_ascii_end() const noexcept -> str
+    {
+        if (this->m_len == 0 || this->m_data == nullptr)
+        {
+            return *this;
+        }
+
+        size_t i = this->m_len - 1;
+        for (; i >= 0; i -= 1)
+        {
+            if (this->m_data[i] != std::byte{0x20})
+            {
+                break;
+            }
+        }
+
+        return str(this->m_data, i + 1);
+    }
+
+    /**
+     * @brief Returns a string slice with all prefixes that match a pattern repeatedly removed.
+     * @param pattern The pattern to search for
+    */
+    [[nodiscard]] auto trim_start_matches(const str& pattern) const noexcept -> str
+    {
+        if (this->m_len == 0 || this->m_data == nullptr || pattern.m_len == 0)
+        {
+            return *this;
+        }
+
+        const std::byte* curr_data = this->m_data;
+        size_t curr_len = this->m_len;
+
+        while (curr_len >= pattern.m_len)
+        {
+            bool matches = std::equal(curr_data, curr_data + pattern.m_len, pattern.m_data);
+
+            if (!matches)
+            {
+                break;
+            }
+
+            curr_data += pattern.m_len;
+            curr_len -= pattern.m_len;
+        }
+
+        return str(curr_data, curr_len);
+    }
+
+    /**
+     * @brief Returns a string slice with all suffixes that match a pattern repeatedly removed.
+     * @param pattern The pattern to search for
+    */
+    [[nodiscard]] auto trim_end_matches(const str& pattern) const noexcept -> str
+    {
+        if (this->m_len == 0 || this->m_data == nullptr || pattern.m_len == 0)
+        {
+            return *this;
+        }
+
+        const std::byte* curr_data = this->m_data;
+        size_t curr_len = this->m_len;
+
+        while (curr_len >= pattern.m_len)
+        {
+            bool matches = std::equal(curr_data + curr_len - pattern.m_len,
+                                    curr_data + curr_len,
+                                    pattern.m_data);
+
+            if (!matches)
+            {
+                break;
+            }
+
+            curr_len -= pattern.m_len;
+        }
+
+        return str(curr_data, curr_len);
+    }
+
+    /**
+     * @brief Returns a string slice with all prefix chars that match a pattern removed.
+     * @param pattern The pattern to search for
+    */
+    template<Pattern P>
+    [[nodiscard]] auto trim_start_matches(const P& pattern) const noexcept -> str
+    {
+        const auto matcher = CharMatcher<P>(pattern);
+        auto rest = *this;
+
+        for (size_t len = matcher.prefix_len(rest); len != 0; len = matcher.prefix_len(rest))
+        {
+            rest = str(rest.m_data + len, rest.m_len - len);
+        }
+
+        return rest;
+    }
+
+    /**
+     * @brief Returns a string slice with all suffix chars that match a pattern removed.
+     * @param pattern The pattern to search for
+    */
+    template<Pattern P>
+    [[nodiscard]] auto trim_end_matches(const P& pattern) const noexcept -> str
+    {
+        const auto matcher = CharMatcher<P>(pattern);
+        auto rest = *this;
+
+        for (size_t len = matcher.suffix_len(rest); len != 0; len = matcher.suffix_len(rest))
+        {
+            rest = str(rest.m_data, rest.m_len - len);
+        }
+
+        return rest;
+    }
+
+    /**
+     * @brief Returns a string slice with all prefix and suffix chars that match a pattern removed.
+     * @param pattern The pattern to search for, such as a CharClass
+    */
+    template<Pattern P>
+    [[nodiscard]] auto trim_matches(const P& pattern) const noexcept -> str
+    {
+        return this->trim_start_matches(pattern).trim_end_matches(pattern);
+    }
+
+private:
+    enum class CaseMapping
+    {
+        Lower,
+        Upper,
+        Fold,
+    };
+
+    /**
+     * @brief Maps a single code point, writing at most 4 code points into out
+     * @return The number of code points written
+     */
+    static auto case_map_char(utf8proc_int32_t codepoint, CaseMapping mapping, utf8proc_int32_t* out) noexcept -> size_t
+    {
+        switch (mapping)
+        {
+            case CaseMapping::Lower:
+                out[0] = utf8proc_tolower(codepoint);
+                return 1;
+
+            case CaseMapping::Upper:
+                out[0] = utf8proc_toupper(codepoint);
+                return 1;
+
+            case CaseMapping::Fold:
+            {
+                int last_boundclass = 0;
+                const auto len = utf8proc_decompose_char(codepoint, out, 4, UTF8PROC_CASEFOLD, &last_boundclass);
+                if (len <= 0 || len > 4)
+                {
+                    out[0] = codepoint;
+                    return 1;
+                }
+
+                return static_cast<size_t>(len);
+            }
+        }
+
+        out[0] = codepoint;
+        return 1;
+    }
+
+    /**
+     * @brief Returns the byte index of the first ASCII lowercase (or uppercase) letter, or the length of this str
+     */
+    [[nodiscard]] auto find_ascii_cased(bool lowercase) const noexcept -> size_t
+    {
+        size_t pos = 0;
+        for (; pos + 8 <= this->m_len; pos += 8)
+        {
+            const auto word = swar::load(this->m_data + pos);
+            if ((lowercase ? swar::ascii_lowercase_mask(word) : swar::ascii_uppercase_mask(word)) != 0)
+            {
+                break;
+            }
+        }
+
+        for (; pos < this->m_len; pos += 1)
+        {
+            const auto ch = Char(static_cast<std::uint8_t>(this->m_data[pos]));
+            if (lowercase ? ch.is_ascii_lowercase() : ch.is_ascii_uppercase())
+            {
+                return pos;
+            }
+        }
+
+        return this->m_len;
+    }
+
+    template<typename Alloc>
+    auto case_map_cow(CaseMapping mapping) const -> Cow<Alloc>
+    {
+        const auto from = this->case_map_first_change(mapping);
+        if (from == this->m_len)
+        {
+            return *this;
+        }
+
+        return this->case_map<Alloc>(mapping, from);
+    }
+
+    /**
+     * @brief Returns the byte index of the first character changed by the case mapping, or the length of this str
+     */
+    [[nodiscard]] auto case_map_first_change(CaseMapping mapping) const noexcept -> size_t
+    {
+        size_t pos = 0;
+        while (pos < this->m_len)
+        {
+            if (pos + 8 <= this->m_len)
+            {
+                const auto word = swar::load(this->m_data + pos);
+                if (!swar::has_non_ascii(word))
+                {
+                    const auto changed = mapping == CaseMapping::Upper ? swar::ascii_lowercase_mask(word) : swar::ascii_uppercase_mask(word);
+                    if (changed == 0)
+                    {
+                        pos += 8;
+                        continue;
+                    }
+                }
+            }
+
+            const auto byte = static_cast<std::uint8_t>(this->m_data[pos]);
+            if (byte < 0x80)
+            {
+                const auto mapped = mapping == CaseMapping::Upper ? swar::to_ascii_uppercase(byte) : swar::to_ascii_lowercase(byte);
+                if (mapped != byte)
+                {
+                    return pos;
+                }
+
+                pos += 1;
+                continue;
+            }
+
+            utf8proc_int32_t codepoint = 0;
+            const auto advance = utf8proc_iterate(
+                reinterpret_cast<const utf8proc_uint8_t*>(this->m_data + pos),
+                this->m_len - pos,
+                &codepoint
+            );
+
+            utf8proc_int32_t mapped[4];
+            if (str::case_map_char(codepoint, mapping, mapped) != 1 || mapped[0] != codepoint)
+            {
+                return pos;
+            }
+            pos += advance;
+        }
+
+        return this->m_len;
+    }
+
+    /**
+     * @brief Copies the bytes before from as is, and case maps the rest
+     */
+    template<typename Alloc>
+    auto case_map(CaseMapping mapping, size_t from = 0) const -> raw::String<Alloc>
+    {
+        auto string = raw::String<Alloc>();
+        string.reserve(this->m_len);
+
+        if (from > 0)
+        {
+            string.push_str_unchecked(str(this->m_data, from));
+        }
+
+        size_t pos = from;
+        while (pos < this->m_len)
+        {
+            // Map the ASCII run directly into the buffer
+            const auto run = swar::ascii_prefix_len(this->m_data + pos, this->m_len - pos);
+            if (run > 0)
+            {
+                string.reserve(run);
+                std::byte* out = string.m_data + string.m_len;
+
+                for (size_t i = 0; i < run; i += 1)
+                {
+                    const auto ch = static_cast<std::uint8_t>(this->m_data[pos + i]);
+                    out[i] = static_cast<std::byte>(mapping == CaseMapping::Upper ? swar::to_ascii_uppercase(ch) : swar::to_ascii_lowercase(ch));
+                }
+
+                string.m_len += run;
+                string.m_data[string.m_len] = std::byte{0};
+                pos += run;
+
+                continue;
+            }
+
+            utf8proc_int32_t codepoint = 0;
+            pos += utf8proc_iterate(
+                reinterpret_cast<const utf8proc_uint8_t*>(this->m_data + pos),
+                this->m_len - pos,
+                &codepoint
+            );
+
+            utf8proc_int32_t mapped[4];
+            const auto count = str::case_map_char(codepoint, mapping, mapped);
+            for (size_t i = 0; i < count; i += 1)
+            {
+                string += Char(static_cast<std::uint32_t>(mapped[i]));
+            }
+        }
+
+        return string;
+    }
+
+    enum class QuickCheck
+    {
+        Yes,
+        No,
+        Maybe,
+    };
+
+    [[nodiscard]] static constexpr auto normalization_options(NormalizationForm form) noexcept -> utf8proc_option_t
+    {
+        switch (form)
+        {
+            case NormalizationForm::NFC:
+                return static_cast<utf8proc_option_t>(UTF8PROC_STABLE | UTF8PROC_COMPOSE);
+
+            case NormalizationForm::NFD:
+                return static_cast<utf8proc_option_t>(UTF8PROC_STABLE | UTF8PROC_DECOMPOSE);
+
+            case NormalizationForm::NFKC:
+                return static_cast<utf8proc_option_t>(UTF8PROC_STABLE | UTF8PROC_COMPOSE | UTF8PROC_COMPAT);
+
+            case NormalizationForm::NFKD:
+                return static_cast<utf8proc_option_t>(UTF8PROC_STABLE | UTF8PROC_DECOMPOSE | UTF8PROC_COMPAT);
+        }
+
+        return UTF8PROC_STABLE;
+    }
+
+    /**
+     * @brief The quick check property of a single code point, it never answers Yes for a code point whose
+     *        Unicode NF*_QC property is No or Maybe, but may answer Maybe for some code points that are Yes
+     */
+    [[nodiscard]] static auto quick_check_char(utf8proc_int32_t codepoint, const utf8proc_property_t* property, NormalizationForm form) noexcept -> QuickCheck
+    {
+        const bool has_decomposition = property->decomp_seqindex != std::numeric_limits<utf8proc_uint16_t>::max();
+        const bool is_canonical = has_decomposition && property->decomp_type == 0;
+        const bool is_hangul_syllable = codepoint >= 0xAC00 && codepoint <= 0xD7A3;
+
+        if (form == NormalizationForm::NFD || form == NormalizationForm::NFKD)
+        {
+            if (is_hangul_syllable || (form == NormalizationForm::NFD ? is_canonical : has_decomposition))
+            {
+                return QuickCheck::No;
+            }
+
+            return QuickCheck::Yes;
+        }
+
+        if (form == NormalizationForm::NFKC && has_decomposition && !is_canonical)
+        {
+            return QuickCheck::No;
+        }
+
+        // Composition exclusions and singletons all lie above U+0300, accented Latin letters below it are composed forms
+        if (is_canonical && codepoint >= 0x0300)
+        {
+            return QuickCheck::Maybe;
+        }
+
+        // Marks and Hangul vowels or trailing consonants may compose with the preceding character
+        const auto category = utf8proc_category(codepoint);
+        if (property->combining_class != 0 ||
+            category == UTF8PROC_CATEGORY_MN || category == UTF8PROC_CATEGORY_MC || category == UTF8PROC_CATEGORY_ME ||
+            (codepoint >= 0x1161 && codepoint <= 0x1175) || (codepoint >= 0x11A8 && codepoint <= 0x11C2))
+        {
+            return QuickCheck::Maybe;
+        }
+
+        return QuickCheck::Yes;
+    }
+
+    /**
+     * @brief Runs the Unicode normalization quick check algorithm over this str, ASCII runs are skipped 8 bytes at a time
+     */
+    [[nodiscard]] auto normalization_quick_check(NormalizationForm form) const noexcept -> QuickCheck
+    {
+        auto result = QuickCheck::Yes;
+        utf8proc_propval_t last_combining_class = 0;
+        size_t pos = 0;
+
+        while (pos < this->m_len)
+        {
+            const auto run = swar::ascii_prefix_len(this->m_data + pos, this->m_len - pos);
+            if (run > 0)
+            {
+                pos += run;
+                last_combining_class = 0;
+                continue;
+            }
+
+            utf8proc_int32_t codepoint = 0;
+            pos += utf8proc_iterate(
+                reinterpret_cast<const utf8proc_uint8_t*>(this->m_data + pos),
+                this->m_len - pos,
+                &codepoint
+            );
+
+            const auto* property = utf8proc_get_property(codepoint);
+            const auto combining_class = property->combining_class;
+
+            // Combining marks must be in canonical order
+            if (combining_class != 0 && last_combining_class > combining_class)
+            {
+                return QuickCheck::No;
+            }
+            last_combining_class = combining_class;
+
+            switch (str::quick_check_char(codepoint, property, form))
+            {
+                case QuickCheck::No:
+                    return QuickCheck::No;
+
+                case QuickCheck::Maybe:
+                    result = QuickCheck::Maybe;
+                    break;
+
+                case QuickCheck::Yes:
+                    break;
+            }
+        }
+
+        return result;
+    }
+
+    template<typename Alloc>
+    auto normalize_slow(NormalizationForm form) const -> raw::String<Alloc>
+    {
+        if (this->m_len == 0)
+        {
+            return raw::String<Alloc>();
+        }
+
+        utf8proc_uint8_t* normalized = nullptr;
+        const auto len = utf8proc_map(
+            reinterpret_cast<const utf8proc_uint8_t*>(this->m_data),
+            static_cast<utf8proc_ssize_t>(this->m_len),
+            &normalized,
+            str::normalization_options(form)
+        );
+
+        if (len < 0)
+        {
+            panic("Failed to normalize while calling str::normalize: {}", utf8proc_errmsg(len));
+        }
+
+        auto string = raw::String<Alloc>(str(reinterpret_cast<pointer>(normalized), static_cast<size_t>(len)));
+        std::free(normalized);
+
+        return string;
+    }
+
+    /**
+     * @brief Lazily yields the full case folding of a str, one code point at a time
+     */
+    struct CaseFoldIter
+    {
+        const std::byte* data = nullptr;
+        size_t len = 0;
+        size_t pos = 0;
+        utf8proc_int32_t pending[4] = {};
+        size_t pending_len = 0;
+        size_t pending_pos = 0;
+
+        constexpr explicit CaseFoldIter(const std::byte* data, size_t len) noexcept : data(data), len(len) {}
+
+        /**
+         * @brief Writes the next folded code point into codepoint
+         * @return false if the str is exhausted
+         */
+        auto next(utf8proc_int32_t& codepoint) noexcept -> bool
+        {
+            if (this->pending_pos < this->pending_len)
+            {
+                codepoint = this->pending[this->pending_pos];
+                this->pending_pos += 1;
+                return true;
+            }
+
+            if (this->pos >= this->len)
+            {
+                return false;
+            }
+
+            const auto byte = static_cast<std::uint8_t>(this->data[this->pos]);
+            if (byte < 0x80)
+            {
+                codepoint = static_cast<utf8proc_int32_t>(swar::to_ascii_lowercase(byte));
+                this->pos += 1;
+                return true;
+            }
+
+            utf8proc_int32_t decoded = 0;
+            this->pos += utf8proc_iterate(
+                reinterpret_cast<const utf8proc_uint8_t*>(this->data + this->pos),
+                this->len - this->pos,
+                &decoded
+            );
+
+            this->pending_len = str::case_map_char(decoded, CaseMapping::Fold, this->pending);
+            this->pending_pos = 1;
+            codepoint = this->pending[0];
+
+            return true;
+        }
+    };
+
+private:
+    /**
+     * @brief Parses an integer with the semantic of std::from_chars in base 10, 8 digits at a time while they fit
+     *        in 64 bits without overflow
+     */
+    template<typename T>
+    [[nodiscard]] constexpr auto parse_integer() const noexcept -> Result<T, ParseNumberError>
+    {
+        using Unsigned = std::make_unsigned_t<T>;
+
+        size_t pos = 0;
+        bool negative = false;
+
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (this->m_len > 0 && this->m_data[0] == std::byte{'-'})
+            {
+                negative = true;
+                pos = 1;
+            }
+        }
+
+        const size_t digits_start = pos;
+        while (pos < this->m_len && this->m_data[pos] == std::byte{'0'})
+        {
+            pos += 1;
+        }
+
+        // At most 19 digits can be accumulated before an overflow check is needed
+        const size_t significant_start = pos;
+        std::uint64_t value = 0;
+
+        if !consteval
+        {
+            while (pos + 8 <= this->m_len && pos - significant_start + 8 <= 19)
+            {
+                const auto word = swar::load_le(this->m_data + pos);
+                if (!swar::is_eight_digits(word))
+                {
+                    break;
+                }
+
+                value = value * 100000000 + swar::parse_eight_digits(word);
+                pos += 8;
+            }
+        }
+
+        bool overflow = false;
+        while (pos < this->m_len)
+        {
+            const auto digit = static_cast<std::uint8_t>(static_cast<std::uint8_t>(this->m_data[pos]) - '0');
+            if (digit > 9)
+            {
+                break;
+            }
+
+            if (value > (std::numeric_limits<std::uint64_t>::max() - digit) / 10)
+            {
+                overflow = true;
+            }
+            else
+            {
+                value = value * 10 + digit;
+            }
+
+            pos += 1;
+        }
+
+        if (pos == digits_start)
+        {
+            return ParseNumberError(std::errc::invalid_argument);
+        }
+
+        const std::uint64_t limit = std::uint64_t(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+        if (overflow || value > limit)
+        {
+            return ParseNumberError(std::errc::result_out_of_range);
+        }
+
+        if (pos != this->m_len)
+        {
+            return ParseNumberError(std::errc::invalid_argument);
+        }
+
+        if (negative)
+        {
+            return static_cast<T>(Unsigned(0) - static_cast<Unsigned>(value));
+        }
+
+        return static_cast<T>(value);
+    }
+
+    /**
+     * @brief Returns the byte index of the first match of the pattern at or after from, or m_len if there is none.
+     * Candidates are located with memchr on the first byte of the pattern. An empty pattern never matches.
+     */
+    [[nodiscard]] auto find_from(const str& pattern, size_t from) const noexcept -> size_t
+    {
+        if (pattern.m_len == 0 || pattern.m_len > this->m_len - from)
+        {
+            return this->m_len;
+        }
+
+        const auto first = std::to_integer<int>(pattern.m_data[0]);
+        const auto last = this->m_data + (this->m_len - pattern.m_len);
+        auto ptr = this->m_data + from;
+
+        while (ptr <= last)
+        {
+            ptr = static_cast<const std::byte*>(std::memchr(ptr, first, size_t(last - ptr) + 1));
+            if (ptr == nullptr)
+            {
+                break;
+            }
+
+            if (std::memcmp(ptr + 1, pattern.m_data + 1, pattern.m_len - 1) == 0)
+            {
+                return size_t(ptr - this->m_data);
+            }
+
+            ptr += 1;
+        }
+
+        return this->m_len;
+    }
+
+    /**
+     * @brief Returns the byte index of the last match of the pattern, or None. An empty pattern never matches.
+     */
+    [[nodiscard]] auto rfind_last(const str& pattern) const noexcept -> Option<size_t>
+    {
+        if (pattern.m_len == 0 || pattern.m_len > this->m_len)
+        {
+            return None{};
+        }
+
+        const auto first = pattern.m_data[0];
+        for (size_t pos = this->m_len - pattern.m_len + 1; pos > 0; pos -= 1)
+        {
+            if (this->m_data[pos - 1] == first && std::memcmp(this->m_data + pos, pattern.m_data + 1, pattern.m_len - 1) == 0)
+            {
+                return pos - 1;
+            }
+        }
+
+        return None{};
+    }
+
+    /**
+     * @brief Decodes the char starting at data, the input must be valid UTF-8
+     * @return The char and its length in bytes
+     */
+    [[nodiscard]] static auto decode_char(const std::byte* data, size_t len) noexcept -> std::pair<Char, size_t>
+    {
+        utf8proc_int32_t codepoint = 0;
+        const auto advance = utf8proc_iterate(reinterpret_cast<const utf8proc_uint8_t*>(data), len, &codepoint);
+
+        return std::pair(Char(static_cast<std::uint32_t>(codepoint)), size_t(advance));
+    }
+
+    /**
+     * @brief Returns the byte index where the char ending at end starts, the input must be valid UTF-8
+     */
+    [[nodiscard]] static constexpr auto char_start_before(const std::byte* data, size_t end) noexcept -> size_t
+    {
+        size_t start = end - 1;
+        while (start > 0 && (std::to_integer<std::uint8_t>(data[start]) & 0xC0) == 0x80)
+        {
+            start -= 1;
+        }
+
+        return start;
+    }
+
+    /**
+     * @brief Searches a str for a Pattern, choosing the fastest strategy the pattern allows:
+     *        - a single char is searched as its UTF-8 encoding with memchr on the first byte, see str::find_from
+     *        - a set of at most 3 ASCII chars is searched 8 bytes at a time, more ASCII chars use a byte lookup table.
+     *          A matching ASCII byte is always a whole char, so no decoding is needed.
+     *        - a CharClass searches with its own byte class table, see CharClass::find_at
+     *        - any other set or predicate decodes the string char by char
+     */
+    template<Pattern P>
+    struct CharMatcher
+    {
+        static constexpr bool is_single = std::same_as<P, char> || std::same_as<P, Char>;
+
+        P pattern;
+        std::array<std::byte, 4> encoded{};
+        size_t encoded_len = 0;
+        std::array<bool, 128> ascii_table{};
+        bool all_ascii = true;
+
+        explicit CharMatcher(const P& pattern) noexcept : pattern(pattern)
+        {
+            if constexpr (is_single)
+            {
+                this->encoded_len = size_t(utf8proc_encode_char(
+                    static_cast<utf8proc_int32_t>(CharMatcher::code_point(pattern)),
+                    reinterpret_cast<utf8proc_uint8_t*>(this->encoded.data())
+                ));
+            }
+            else if constexpr (CharSet<P>)
+            {
+                for (const auto& element : pattern)
+                {
+                    const auto value = CharMatcher::code_point(element);
+                    if (value < 0x80)
+                    {
+                        this->ascii_table[value] = true;
+                    }
+                    else
+                    {
+                        this->all_ascii = false;
+                    }
+                }
+            }
+        }
+
+        template<typename C>
+        [[nodiscard]] static constexpr auto code_point(const C& ch) noexcept -> std::uint32_t
+        {
+            if constexpr (std::same_as<C, char>)
+            {
+                return static_cast<unsigned char>(ch);
+            }
+            else
+            {
+                return ch.code_point();
+            }
+        }
+
+        [[nodiscard]] auto is_match(const Char& ch) const noexcept -> bool
+        {
+            if constexpr (std::same_as<P, CharClass>)
+            {
+                return this->pattern.contains(ch);
+            }
+            else if constexpr (CharSet<P>)
+            {
+                return std::ranges::any_of(this->pattern, [&](const auto& element) { return CharMatcher::code_point(element) == ch.code_point(); });
+            }
+            else
+            {
+                return std::invoke(this->pattern, ch);
+            }
+        }
+
+        [[nodiscard]] auto as_str() const noexcept -> str
+        {
+            return str(this->encoded.data(), this->encoded_len);
+        }
+
+        /**
+         * @brief Returns the byte index and the length of the first match at or after from, the index is s.size() if there is none
+         */
+        [[nodiscard]] auto find(const str& s, size_t from) const noexcept -> std::pair<size_t, size_t>
+        {
+            if constexpr (is_single)
+            {
+                return std::pair(s.find_from(this->as_str(), from), this->encoded_len);
+            }
+            else if constexpr (std::same_as<P, CharClass>)
+            {
+                const auto pos = this->pattern.find_at(s, from);
+                if (pos.is_none())
+                {
+                    return std::pair(s.m_len, size_t(0));
+                }
+
+                return std::pair(pos.unwrap(), str::decode_char(s.m_data + pos.unwrap(), s.m_len - pos.unwrap()).second);
+            }
+            else
+            {
+                if constexpr (CharSet<P>)
+                {
+                    if (this->all_ascii)
+                    {
+                        return std::pair(this->find_ascii(s, from), size_t(1));
+                    }
+                }
+
+                for (size_t pos = from; pos < s.m_len;)
+                {
+                    const auto [ch, len] = str::decode_char(s.m_data + pos, s.m_len - pos);
+                    if (this->is_match(ch))
+                    {
+                        return std::pair(pos, len);
+                    }
+
+                    pos += len;
+                }
+
+                return std::pair(s.m_len, size_t(0));
+            }
+        }
+
+        /**
+         * @brief Returns the byte index and the length of the last match, the index is s.size() if there is none
+         */
+        [[nodiscard]] auto rfind(const str& s) const noexcept -> std::pair<size_t, size_t>
+        {
+            if constexpr (is_single)
+            {
+                const auto pos = s.rfind_last(this->as_str());
+                return std::pair(pos.is_some() ? pos.unwrap() : s.m_len, this->encoded_len);
+            }
+            else
+            {
+                for (size_t end = s.m_len; end > 0;)
+                {
+                    if constexpr (CharSet<P>)
+                    {
+                        if (this->all_ascii)
+                        {
+                            const auto byte = std::to_integer<std::uint8_t>(s.m_data[end - 1]);
+                            if (byte < 0x80 && this->ascii_table[byte])
+                            {
+                                return std::pair(end - 1, size_t(1));
+                            }
+
+                            end -= 1;
+                            continue;
+                        }
+                    }
+
+                    const size_t start = str::char_start_before(s.m_data, end);
+                    if (this->is_match(str::decode_char(s.m_data + start, end - start).first))
+                    {
+                        return std::pair(start, end - start);
+                    }
+
+                    end = start;
+                }
+
+                return std::pair(s.m_len, size_t(0));
+            }
+        }
+
+        /**
+         * @brief Returns the length of the match at the start of the string, or 0 if the string does not start with a match
+         */
+        [[nodiscard]] auto prefix_len(const str& s) const noexcept -> size_t
+        {
+            if constexpr (is_single)
+            {
+                return s.starts_with(this->as_str()) ? this->encoded_len : 0;
+            }
+            else
+            {
+                if (s.m_len == 0)
+                {
+                    return 0;
+                }
+
+                const auto [ch, len] = str::decode_char(s.m_data, s.m_len);
+                return this->is_match(ch) ? len : 0;
+            }
+        }
+
+        /**
+         * @brief Returns the length of the match at the end of the string, or 0 if the string does not end with a match
+         */
+        [[nodiscard]] auto suffix_len(const str& s) const noexcept -> size_t
+        {
+            if constexpr (is_single)
+            {
+                return s.ends_with(this->as_str()) ? this->encoded_len : 0;
+            }
+            else
+            {
+                if (s.m_len == 0)
+                {
+                    return 0;
+                }
+
+                const size_t start = str::char_start_before(s.m_data, s.m_len);
+                return this->is_match(str::decode_char(s.m_data + start, s.m_len - start).first) ? s.m_len - start : 0;
+            }
+        }
+
+    private:
+        [[nodiscard]] auto find_ascii(const str& s, size_t from) const noexcept -> size_t
+        {
+            size_t pos = from;
+
+            if constexpr (std::tuple_size_v<P> > 0 && std::tuple_size_v<P> <= 3)
+            {
+                // Like memchr2 and memchr3, compare 8 bytes against every needle at once, missing needles repeat the first one
+                std::array<std::uint8_t, 3> needles{};
+                for (size_t i = 0; i < needles.size(); i += 1)
+                {
+                    needles[i] = static_cast<std::uint8_t>(CharMatcher::code_point(this->pattern[std::min(i, std::tuple_size_v<P> - 1)]));
+                }
+
+                while (pos + 8 <= s.m_len)
+                {
+                    const auto word = swar::load_le(s.m_data + pos);
+                    const auto mask = swar::eq_mask(word, needles[0]) | swar::eq_mask(word, needles[1]) | swar::eq_mask(word, needles[2]);
+
+                    if (mask != 0)
+                    {
+                        return pos + size_t(std::countr_zero(mask) / 8);
+                    }
+
+                    pos += 8;
+                }
+            }
+
+            for (; pos < s.m_len; pos += 1)
+            {
+                const auto byte = std::to_integer<std::uint8_t>(s.m_data[pos]);
+                if (byte < 0x80 && this->ascii_table[byte])
+                {
+                    return pos;
+                }
+            }
+
+            return s.m_len;
+        }
+    };
+
+// iterators
+private:
+    /**
+     * @brief The iterator of str::lines, it yields str by value.
+     * The iterators hold the bytes of the string rather than the str, so the yielded lines stay valid as long as the bytes do.
+     */
+    struct Lines
+    {
+        struct LinesIter
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = str;
+            using difference_type = std::ptrdiff_t;
+            using reference = str;
+
+            plain_str s;
+            plain_str span;
+            uint32_t skip = 0;
+            bool done = true;
+
+            constexpr explicit LinesIter() noexcept {}
+
+            constexpr explicit LinesIter(const plain_str& s) noexcept : s(s), done(false)
+            {
+                this->find_line(0);
+            }
+
+            [[nodiscard]] constexpr auto operator*() const noexcept -> reference
+            {
+                return this->span;
+            }
+
+            /**
+             * @brief Returns the byte index of the current line in the string
+             * @note Must not be called on the end iterator
+             */
+            [[nodiscard]] constexpr auto position() const noexcept -> size_t
+            {
+                return size_t(this->span.data - this->s.data);
+            }
+
+            /**
+             * @brief Returns the rest of the string, starting at the current line
+             * @note Must not be called on the end iterator
+             */
+            [[nodiscard]] constexpr auto remainder() const noexcept -> str
+            {
+                return plain_str(this->span.data, this->s.len - this->position());
+            }
+
+            constexpr auto operator++() noexcept -> LinesIter&
+            {
+                if (this->done)
+                {
+                    return *this;
+                }
+
+                const size_t start = this->position() + this->span.len + this->skip;
+
+                // If we're at or past the end, mark as finished
+                if (start >= this->s.len)
+                {
+                    this->done = true;
+                    this->span = plain_str();
+                    return *this;
+                }
+
+                this->find_line(start);
+                return *this;
+            }
+
+            constexpr auto operator++(int) noexcept -> LinesIter
+            {
+                LinesIter temp = *this;
+                ++(*this);
+                return temp;
+            }
+
+            [[nodiscard]] constexpr auto operator==(const LinesIter& other) const noexcept -> bool
+            {
+                return this->done == other.done && this->span.data == other.span.data;
+            }
+
+        private:
+            constexpr auto find_line(size_t start) noexcept -> void
+            {
+                const auto bytes = this->s.data;
+
+                for (size_t pos = start; pos < this->s.len; pos++)
+                {
+                    if (bytes[pos] == std::byte{'\n'})
+                    {
+                        this->span = plain_str(bytes + start, pos - start);
+                        this->skip = 1;
+                        return;
+                    }
+
+                    if (bytes[pos] == std::byte{'\r'} && pos + 1 < this->s.len && bytes[pos + 1] == std::byte{'\n'})
+                    {
+                        this->span = plain_str(bytes + start, pos - start);
+                        this->skip = 2;
+                        return;
+                    }
+                }
+
+                // If no line ending found, take the rest of the string
+                this->span = plain_str(bytes + start, this->s.len - start);
+                this->skip = 0;
+            }
+        };
+
+    public:
+        plain_str s;
+
+    public:
+        constexpr explicit Lines(const plain_str& s) noexcept : s(s) {}
+
+    public:
+        [[nodiscard]] constexpr auto begin() const noexcept -> LinesIter
+        {
+            return LinesIter(this->s);
+        }
+
+        [[nodiscard]] constexpr auto end() const noexcept -> LinesIter
+        {
+            return LinesIter();
+        }
+
+        using iterator = LinesIter;
+        using const_iterator = LinesIter;
+    };
+
+    struct Matches
+    {
+        struct MatchesIter
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = size_t;
+            using pointer = const size_t*;
+            using reference = const size_t&;
+
+            plain_str s;
+            plain_str pattern;
+            size_t match_pos = 0;
+            bool done = true;
+
+            constexpr MatchesIter() noexcept = default;
+
+            constexpr MatchesIter(const plain_str& s, const plain_str& pattern) noexcept : s(s), pattern(pattern), done(pattern.len == 0)
+            {
+                // Find the first match
+                if (!this->done)
+                {
+                    this->find_match(0);
+                }
+            }
+
+            [[nodiscard]] constexpr auto operator*() const noexcept -> reference
+            {
+                return this->match_pos;
+            }
+
+            [[nodiscard]] constexpr auto operator->() const noexcept -> pointer
+            {
+                return &this->match_pos;
+            }
+
+            constexpr auto operator++() noexcept -> MatchesIter&
+            {
+                if (this->done)
+                {
+                    return *this;
+                }
+
+                // Search for the next match starting from the position after the last match
+                this->find_match(this->match_pos + this->pattern.len);
+                return *this;
+            }
+
+            constexpr auto operator++(int) noexcept -> MatchesIter
+            {
                 MatchesIter temp = *this;
                 ++(*this);
                 return temp;
             }
 
-            [[nodiscard]] constexpr auto operator==(const MatchesIter& other) const noexcept -> bool
+            [[nodiscard]] constexpr auto operator==(const MatchesIter& other) const noexcept -> bool
+            {
+                return this->done == other.done && (this->done || this->match_pos == other.match_pos);
+            }
+
+        private:
+            constexpr auto find_match(size_t from) noexcept -> void
+            {
+                const auto last = this->s.data + this->s.len;
+                const auto ptr = std::search(this->s.data + from, last, this->pattern.data, this->pattern.data + this->pattern.len);
+
+                if (ptr != last)
+                {
+                    this->match_pos = size_t(ptr - this->s.data);
+                }
+                else
+                {
+                    // No more matches, set to end iterator
+                    this->done = true;
+                    this->match_pos = 0;
+                }
+            }
+        };
+
+        plain_str s;
+        plain_str pattern;
+
+        constexpr Matches(const plain_str& s, const plain_str& pattern) noexcept : s(s), pattern(pattern) {}
+
+        [[nodiscard]] constexpr auto begin() const noexcept -> MatchesIter
+        {
+            return MatchesIter(this->s, this->pattern);
+        }
+
+        [[nodiscard]] constexpr auto end() const noexcept -> MatchesIter
+        {
+            return MatchesIter();
+        }
+
+        using iterator = MatchesIter;
+        using const_iterator = MatchesIter;
+    };
+
+    /**
+     * @brief The iterator of str::split, it yields str by value.
+     * Like Lines, the iterators hold the bytes of the string rather than the str.
+     */
+    struct Split
+    {
+        struct SplitIter
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = str;
+            using reference = str;
+
+            plain_str s;
+            plain_str pattern;
+            plain_str span;
+            bool done = true;
+
+            constexpr SplitIter() noexcept = default;
+
+            constexpr SplitIter(const plain_str& s, const plain_str& pattern) noexcept : s(s), pattern(pattern), done(false)
+            {
+                // If pattern is empty, return the entire string
+                if (pattern.len == 0)
+                {
+                    this->span = s;
+                    return;
+                }
+
+                this->find_part(0);
+            }
+
+            [[nodiscard]] constexpr auto operator*() const noexcept -> reference
+            {
+                return this->span;
+            }
+
+            /**
+             * @brief Returns the byte index of the current part in the string
+             * @note Must not be called on the end iterator
+             */
+            [[nodiscard]] constexpr auto position() const noexcept -> size_t
+            {
+                return size_t(this->span.data - this->s.data);
+            }
+
+            /**
+             * @brief Returns the rest of the string, starting at the current part
+             * @note Must not be called on the end iterator
+             */
+            [[nodiscard]] constexpr auto remainder() const noexcept -> str
+            {
+                return plain_str(this->span.data, this->s.len - this->position());
+            }
+
+            constexpr auto operator++() noexcept -> SplitIter&
+            {
+                if (this->done)
+                {
+                    return *this;
+                }
+
+                // Skip the delimiter
+                const size_t start = this->position() + this->span.len + this->pattern.len;
+
+                // If reached the end after skipping delimiter, end iteration
+                if (start >= this->s.len)
+                {
+                    this->done = true;
+                    this->span = plain_str();
+                    return *this;
+                }
+
+                this->find_part(start);
+                return *this;
+            }
+
+            constexpr auto operator++(int) noexcept -> SplitIter
+            {
+                SplitIter temp = *this;
+                ++(*this);
+                return temp;
+            }
+
+            [[nodiscard]] constexpr auto operator==(const SplitIter& other) const noexcept -> bool
+            {
+                return this->done == other.done && this->span.data == other.span.data;
+            }
+
+        private:
+            constexpr auto find_part(size_t start) noexcept -> void
+            {
+                const auto last = this->s.data + this->s.len;
+                const auto ptr = std::search(this->s.data + start, last, this->pattern.data, this->pattern.data + this->pattern.len);
+                this->span = plain_str(this->s.data + start, size_t(ptr - this->s.data) - start);
+            }
+        };
+
+    public:
+        using iterator = SplitIter;
+        using const_iterator = SplitIter;
+
+        plain_str s;
+        plain_str pattern;
+
+    public:
+        constexpr Split(const plain_str& s, const plain_str& pattern) noexcept : s(s), pattern(pattern) {}
+
+    public:
+        [[nodiscard]] constexpr auto begin() const noexcept -> SplitIter
+        {
+            return SplitIter(this->s, this->pattern);
+        }
+
+        [[nodiscard]] constexpr auto end() const noexcept -> SplitIter
+        {
+            return SplitIter();
+        }
+    };
+
+    enum class SplitKind
+    {
+        N,
+        ReverseN,
+        Terminator,
+        Inclusive,
+    };
+
+    /**
+     * @brief The iterators of splitn, rsplitn, split_terminator and split_inclusive, they yield str by value.
+     * The parts are stored as plain_str since str is still incomplete here.
+     */
+    template<SplitKind Kind>
+    struct SplitPieces
+    {
+        struct SplitPiecesIter
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = str;
+            using reference = str;
+
+            plain_str rest;
+            plain_str pattern;
+            size_t remaining = 0;
+            plain_str current;
+            bool done = true;
+
+            constexpr SplitPiecesIter() noexcept = default;
+
+            SplitPiecesIter(const plain_str& rest, const plain_str& pattern, size_t n) noexcept : rest(rest), pattern(pattern), remaining(n), done(false)
+            {
+                this->advance();
+            }
+
+            [[nodiscard]] auto operator*() const noexcept -> reference
+            {
+                return this->current;
+            }
+
+            auto operator++() noexcept -> SplitPiecesIter&
+            {
+                if (!this->done)
+                {
+                    this->advance();
+                }
+
+                return *this;
+            }
+
+            auto operator++(int) noexcept -> SplitPiecesIter
+            {
+                auto temp = *this;
+                ++(*this);
+
+                return temp;
+            }
+
+            [[nodiscard]] auto operator==(const SplitPiecesIter& other) const noexcept -> bool
+            {
+                return this->done == other.done && (this->done || this->current == other.current);
+            }
+
+        private:
+            auto advance() noexcept -> void
+            {
+                const str rest = this->rest;
+                const str pattern = this->pattern;
+
+                if constexpr (Kind == SplitKind::N)
+                {
+                    if (this->remaining == 0)
+                    {
+                        this->done = true;
+                        return;
+                    }
+
+                    this->remaining -= 1;
+                    const size_t pos = this->remaining > 0 ? rest.find_from(pattern, 0) : rest.m_len;
+
+                    if (pos < rest.m_len)
+                    {
+                        this->current = plain_str(rest.m_data, pos);
+                        this->rest = plain_str(rest.m_data + pos + pattern.m_len, rest.m_len - pos - pattern.m_len);
+                    }
+                    else
+                    {
+                        this->current = this->rest;
+                        this->remaining = 0;
+                    }
+                }
+                else if constexpr (Kind == SplitKind::ReverseN)
+                {
+                    if (this->remaining == 0)
+                    {
+                        this->done = true;
+                        return;
+                    }
+
+                    this->remaining -= 1;
+                    const auto pos = this->remaining > 0 ? rest.rfind_last(pattern) : Option<size_t>(None{});
+
+                    if (pos.is_some())
+                    {
+                        const size_t end = pos.unwrap() + pattern.m_len;
+                        this->current = plain_str(rest.m_data + end, rest.m_len - end);
+                        this->rest = plain_str(rest.m_data, pos.unwrap());
+                    }
+                    else
+                    {
+                        this->current = this->rest;
+                        this->remaining = 0;
+                    }
+                }
+                else if constexpr (Kind == SplitKind::Terminator)
+                {
+                    const size_t pos = rest.find_from(pattern, 0);
+
+                    // The empty piece after a trailing delimiter, or of an empty string, is not yielded
+                    if (this->remaining == 0 || (pos == rest.m_len && rest.m_len == 0))
+                    {
+                        this->done = true;
+                        return;
+                    }
+
+                    if (pos < rest.m_len)
+                    {
+                        this->current = plain_str(rest.m_data, pos);
+                        this->rest = plain_str(rest.m_data + pos + pattern.m_len, rest.m_len - pos - pattern.m_len);
+                        this->remaining = this->rest.len > 0 ? 1 : 0;
+                    }
+                    else
+                    {
+                        this->current = this->rest;
+                        this->remaining = 0;
+                    }
+                }
+                else
+                {
+                    if (rest.m_len == 0)
+                    {
+                        this->done = true;
+                        return;
+                    }
+
+                    const size_t pos = rest.find_from(pattern, 0);
+                    const size_t end = pos < rest.m_len ? pos + pattern.m_len : rest.m_len;
+
+                    this->current = plain_str(rest.m_data, end);
+                    this->rest = plain_str(rest.m_data + end, rest.m_len - end);
+                }
+            }
+        };
+
+    public:
+        using iterator = SplitPiecesIter;
+        using const_iterator = SplitPiecesIter;
+
+        plain_str s;
+        plain_str pattern;
+        size_t n = 0;
+
+    public:
+        constexpr SplitPieces(const plain_str& s, const plain_str& pattern, size_t n) noexcept : s(s), pattern(pattern), n(n) {}
+
+    public:
+        [[nodiscard]] auto begin() const noexcept -> SplitPiecesIter
+        {
+            return SplitPiecesIter(this->s, this->pattern, this->n);
+        }
+
+        [[nodiscard]] auto end() const noexcept -> SplitPiecesIter
+        {
+            return SplitPiecesIter();
+        }
+    };
+
+    /**
+     * @brief The iterator of matches for a Pattern, it yields the byte index of each match
+     */
+    template<Pattern P>
+    struct PatternMatches
+    {
+        struct PatternMatchesIter
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = size_t;
+            using pointer = const size_t*;
+            using reference = const size_t&;
+
+            copyable_box<CharMatcher<P>> matcher;
+            plain_str s;
+            size_t match_pos = 0;
+            size_t next = 0;
+            bool done = true;
+
+            constexpr PatternMatchesIter() noexcept = default;
+
+            PatternMatchesIter(const copyable_box<CharMatcher<P>>& matcher, const plain_str& s) noexcept : matcher(matcher), s(s), done(false)
+            {
+                this->advance();
+            }
+
+            [[nodiscard]] auto operator*() const noexcept -> reference
+            {
+                return this->match_pos;
+            }
+
+            [[nodiscard]] auto operator->() const noexcept -> pointer
+            {
+                return &this->match_pos;
+            }
+
+            auto operator++() noexcept -> PatternMatchesIter&
+            {
+                if (!this->done)
+                {
+                    this->advance();
+                }
+
+                return *this;
+            }
+
+            auto operator++(int) noexcept -> PatternMatchesIter
+            {
+                auto temp = *this;
+                ++(*this);
+
+                return temp;
+            }
+
+            [[nodiscard]] auto operator==(const PatternMatchesIter& other) const noexcept -> bool
+            {
+                return this->done == other.done && (this->done || this->match_pos == other.match_pos);
+            }
+
+        private:
+            auto advance() noexcept -> void
+            {
+                const auto [pos, len] = this->matcher->find(this->s, this->next);
+                if (pos == this->s.len)
+                {
+                    this->done = true;
+                    return;
+                }
+
+                this->match_pos = pos;
+                this->next = pos + len;
+            }
+        };
+
+    public:
+        using iterator = PatternMatchesIter;
+        using const_iterator = PatternMatchesIter;
+
+        plain_str s;
+        copyable_box<CharMatcher<P>> matcher;
+
+    public:
+        PatternMatches(const plain_str& s, const P& pattern) noexcept : s(s), matcher(CharMatcher<P>(pattern)) {}
+
+    public:
+        [[nodiscard]] auto begin() const noexcept -> PatternMatchesIter
+        {
+            return PatternMatchesIter(this->matcher, this->s);
+        }
+
+        [[nodiscard]] auto end() const noexcept -> PatternMatchesIter
+        {
+            return PatternMatchesIter();
+        }
+    };
+
+    /**
+     * @brief The iterator of split for a Pattern, it yields the same parts as str::split would for an equivalent str pattern,
+     * as str by value
+     */
+    template<Pattern P>
+    struct PatternSplit
+    {
+        struct PatternSplitIter
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = str;
+            using reference = str;
+
+            copyable_box<CharMatcher<P>> matcher;
+            plain_str s;
+            plain_str current;
+            size_t next = 0;
+            bool done = true;
+
+            constexpr PatternSplitIter() noexcept = default;
+
+            PatternSplitIter(const copyable_box<CharMatcher<P>>& matcher, const plain_str& s) noexcept : matcher(matcher), s(s), done(false)
+            {
+                this->advance(0);
+            }
+
+            [[nodiscard]] auto operator*() const noexcept -> reference
+            {
+                return this->current;
+            }
+
+            auto operator++() noexcept -> PatternSplitIter&
+            {
+                if (this->done)
+                {
+                    return *this;
+                }
+
+                // Like str::split, the empty part after a trailing delimiter is not yielded
+                if (this->next >= this->s.len)
+                {
+                    this->done = true;
+                    return *this;
+                }
+
+                this->advance(this->next);
+                return *this;
+            }
+
+            auto operator++(int) noexcept -> PatternSplitIter
+            {
+                auto temp = *this;
+                ++(*this);
+
+                return temp;
+            }
+
+            [[nodiscard]] auto operator==(const PatternSplitIter& other) const noexcept -> bool
+            {
+                return this->done == other.done && (this->done || this->current == other.current);
+            }
+
+        private:
+            auto advance(size_t from) noexcept -> void
+            {
+                const auto [pos, len] = this->matcher->find(this->s, from);
+
+                this->current = plain_str(this->s.data + from, pos - from);
+                this->next = pos < this->s.len ? pos + len : this->s.len + 1;
+            }
+        };
+
+    public:
+        using iterator = PatternSplitIter;
+        using const_iterator = PatternSplitIter;
+
+        plain_str s;
+        copyable_box<CharMatcher<P>> matcher;
+
+    public:
+        PatternSplit(const plain_str& s, const P& pattern) noexcept : s(s), matcher(CharMatcher<P>(pattern)) {}
+
+    public:
+        [[nodiscard]] auto begin() const noexcept -> PatternSplitIter
+        {
+            return PatternSplitIter(this->matcher, this->s);
+        }
+
+        [[nodiscard]] auto end() const noexcept -> PatternSplitIter
+        {
+            return PatternSplitIter();
+        }
+    };
+
+    /**
+     * @brief The iterator of str::split_ascii_whitespace, it yields str by value.
+     * Like Lines, the iterators hold the bytes of the string rather than the str.
+     */
+    struct SplitASCIIWhiteSpace
+    {
+    public:
+        plain_str s;
+
+        struct SplitASCIIWhiteSpaceIter
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = str;
+            using reference = str;
+
+        public:
+            plain_str s;
+            plain_str span;
+            size_t pos = 0;
+            bool done = true;
+
+            constexpr explicit SplitASCIIWhiteSpaceIter() noexcept = default;
+
+            explicit SplitASCIIWhiteSpaceIter(const plain_str& s) noexcept : s(s), done(false)
+            {
+                ++(*this);
+            }
+
+            auto operator++() noexcept -> SplitASCIIWhiteSpaceIter&
+            {
+                if (this->done)
+                {
+                    return *this;
+                }
+
+                utf8proc_int32_t codepoint = 0;
+                const auto size = this->s.len;
+
+                // Skip whitespace
+                while (this->pos < size)
+                {
+                    const auto advance = utf8proc_iterate(
+                        reinterpret_cast<const utf8proc_uint8_t*>(this->s.data + this->pos),
+                        size - this->pos,
+                        &codepoint
+                    );
+
+                    if (!std::bit_cast<Char>(codepoint).is_ascii_whitespace())
+                    {
+                        break;
+                    }
+
+                    this->pos += advance;
+                }
+
+                // If we've reached the end, set to end iterator
+                if (this->pos >= size)
+                {
+                    this->done = true;
+                    this->span = plain_str();
+                    return *this;
+                }
+
+                // Find the end of the current non-whitespace sequence
+                const auto start_pos = this->pos;
+                while (this->pos < size)
+                {
+                    const auto advance = utf8proc_iterate(
+                        reinterpret_cast<const utf8proc_uint8_t*>(this->s.data + this->pos),
+                        size - this->pos,
+                        &codepoint
+                    );
+
+                    if (std::bit_cast<Char>(codepoint).is_ascii_whitespace())
+                    {
+                        break;
+                    }
+
+                    this->pos += advance;
+                }
+
+                this->span = plain_str(this->s.data + start_pos, this->pos - start_pos);
+
+                return *this;
+            }
+
+            [[nodiscard]] auto operator++(int) noexcept -> SplitASCIIWhiteSpaceIter
+            {
+                SplitASCIIWhiteSpaceIter temp = *this;
+                ++(*this);
+                return temp;
+            }
+
+            [[nodiscard]] constexpr auto operator==(const SplitASCIIWhiteSpaceIter& other) const noexcept -> bool
+            {
+                return this->done == other.done && this->span.data == other.span.data;
+            }
+
+            [[nodiscard]] constexpr auto operator*() const noexcept -> reference
+            {
+                return this->span;
+            }
+
+            /**
+             * @brief Returns the byte index of the current part in the string
+             * @note Must not be called on the end iterator
+             */
+            [[nodiscard]] constexpr auto position() const noexcept -> size_t
+            {
+                return size_t(this->span.data - this->s.data);
+            }
+
+            /**
+             * @brief Returns the rest of the string, starting at the current part
+             * @note Must not be called on the end iterator
+             */
+            [[nodiscard]] constexpr auto remainder() const noexcept -> str
+            {
+                return plain_str(this->span.data, this->s.len - this->position());
+            }
+        };
+
+    public:
+        constexpr explicit SplitASCIIWhiteSpace(const plain_str& s) : s(s) {}
+
+    public:
+        [[nodiscard]] auto begin() const noexcept -> SplitASCIIWhiteSpaceIter
+        {
+            return SplitASCIIWhiteSpaceIter(this->s);
+        }
+
+        [[nodiscard]] auto end() const noexcept -> SplitASCIIWhiteSpaceIter
+        {
+            return SplitASCIIWhiteSpaceIter();
+        }
+
+        using iterator = SplitASCIIWhiteSpaceIter;
+        using const_iterator = SplitASCIIWhiteSpaceIter;
+    };
+
+    struct Chars
+    {
+        plain_str s;
+
+        struct CharsIter
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = Char;
+            using pointer = const Char*;
+            using reference = const Char&;
+
+            plain_str s;
+            size_t pos = 0;
+            size_t len = 0;
+            Char ch;
+
+            constexpr explicit CharsIter() noexcept = default;
+
+            explicit CharsIter(const plain_str& s, size_t pos) noexcept : s(s), pos(pos)
+            {
+                this->decode();
+            }
+
+            auto operator++() noexcept -> CharsIter&
+            {
+                this->pos += this->len;
+                this->decode();
+
+                return *this;
+            }
+
+            auto operator++(int) noexcept -> CharsIter
+            {
+                CharsIter temp = *this;
+                ++(*this);
+                return temp;
+            }
+
+            constexpr auto operator->() const noexcept -> pointer
+            {
+                return std::bit_cast<const Char*>(&this->ch);
+            }
+
+            constexpr auto operator*() const noexcept -> reference
+            {
+                return this->ch;
+            }
+
+            [[nodiscard]] constexpr auto operator==(const CharsIter& other) const noexcept -> bool
+            {
+                return this->pos == other.pos;
+            }
+
+        private:
+            auto decode() noexcept -> void
+            {
+                if (this->pos >= this->s.len)
+                {
+                    this->len = 0;
+                    return;
+                }
+
+                // ASCII needs no decoding, this keeps the loop over ASCII text free of calls
+                const auto byte = std::to_integer<std::uint32_t>(this->s.data[this->pos]);
+                if (byte < 0x80)
+                {
+                    this->ch = Char(byte);
+                    this->len = 1;
+                    return;
+                }
+
+                std::tie(this->ch, this->len) = str::decode_char(this->s.data + this->pos, this->s.len - this->pos);
+            }
+        };
+
+        constexpr explicit Chars(const plain_str& s) noexcept : s(s) {}
+
+        auto begin() const noexcept -> CharsIter
+        {
+            return CharsIter(this->s, 0);
+        }
+
+        auto end() const noexcept -> CharsIter
+        {
+            return CharsIter(this->s, this->s.len);
+        }
+
+        using iterator = CharsIter;
+        using const_iterator = CharsIter;
+    };
+
+    /**
+     * @brief The iterator of str::graphemes, it yields str by value.
+     * Like Lines, the iterators hold the bytes of the string rather than the str.
+     */
+    struct Graphemes
+    {
+        plain_str s;
+
+        struct GraphemesIter
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = str;
+            using reference = str;
+
+            plain_str s;
+            plain_str current;
+            utf8proc_int32_t state = 0;
+
+            constexpr explicit GraphemesIter() noexcept = default;
+
+            constexpr explicit GraphemesIter(const plain_str& s, size_t pos) noexcept : s(s)
+            {
+                this->advance(pos);
+            }
+
+            constexpr auto advance(size_t pos) noexcept -> void
+            {
+                const auto size = this->s.len;
+                const size_t start_pos = pos;
+
+                if (pos >= size)
+                {
+                    this->current = plain_str(this->s.data + size, 0);
+                    return;
+                }
+
+                utf8proc_int32_t codepoint1 = 0;
+                utf8proc_int32_t codepoint2 = 0;
+
+                // Get the first codepoint
+                auto advance = utf8proc_iterate(
+                    reinterpret_cast<const utf8proc_uint8_t*>(this->s.data + pos),
+                    size - pos,
+                    &codepoint1
+                );
+                pos += advance;
+
+                // Keep advancing until we find a grapheme break
+                while (pos < size)
+                {
+                    advance = utf8proc_iterate(
+                        reinterpret_cast<const utf8proc_uint8_t*>(this->s.data + pos),
+                        size - pos,
+                        &codepoint2
+                    );
+
+                    if (utf8proc_grapheme_break_stateful(codepoint1, codepoint2, &this->state))
+                    {
+                        break;
+                    }
+
+                    codepoint1 = codepoint2;
+                    pos += advance;
+                }
+
+                this->current = plain_str(this->s.data + start_pos, pos - start_pos);
+            }
+
+            constexpr auto operator++() noexcept -> GraphemesIter&
+            {
+                this->advance(size_t(this->current.data - this->s.data) + this->current.len);
+                return *this;
+            }
+
+            constexpr auto operator++(int) noexcept -> GraphemesIter
+            {
+                GraphemesIter temp = *this;
+                ++(*this);
+                return temp;
+            }
+
+            [[nodiscard]] constexpr auto operator==(const GraphemesIter& other) const noexcept -> bool
+            {
+                return this->current.data == other.current.data;
+            }
+
+            [[nodiscard]] constexpr auto operator*() const noexcept -> reference
+            {
+                return this->current;
+            }
+        };
+
+        constexpr explicit Graphemes(const plain_str& s) noexcept : s(s) {}
+
+        [[nodiscard]] constexpr auto begin() const noexcept -> GraphemesIter
+        {
+            return GraphemesIter(this->s, 0);
+        }
+
+        [[nodiscard]] constexpr auto end() const noexcept -> GraphemesIter
+        {
+            return GraphemesIter(this->s, this->s.len);
+        }
+
+        using iterator = GraphemesIter;
+        using const_iterator = GraphemesIter;
+    };
+
+    /**
+     * @brief The iterator of str::encode_utf16, it yields the UTF-16 code units of the string by value.
+     * A char outside the BMP yields its high surrogate, then its low surrogate.
+     */
+    struct EncodeUtf16
+    {
+        plain_str s;
+
+        struct EncodeUtf16Iter
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = char16_t;
+            using reference = char16_t;
+
+            plain_str s;
+            size_t pos = 0;
+            size_t len = 0;
+            std::array<char16_t, 2> units = {};
+            bool low = false;
+
+            constexpr explicit EncodeUtf16Iter() noexcept = default;
+
+            explicit EncodeUtf16Iter(const plain_str& s, size_t pos) noexcept : s(s), pos(pos)
+            {
+                this->decode();
+            }
+
+            auto operator++() noexcept -> EncodeUtf16Iter&
+            {
+                // A low surrogate is never 0, so a second code unit means the char is a surrogate pair
+                if (!this->low && this->units[1] != 0)
+                {
+                    this->low = true;
+                    return *this;
+                }
+
+                this->pos += this->len;
+                this->low = false;
+                this->decode();
+
+                return *this;
+            }
+
+            auto operator++(int) noexcept -> EncodeUtf16Iter
+            {
+                EncodeUtf16Iter temp = *this;
+                ++(*this);
+                return temp;
+            }
+
+            [[nodiscard]] constexpr auto operator*() const noexcept -> reference
+            {
+                return this->units[this->low ? 1 : 0];
+            }
+
+            [[nodiscard]] constexpr auto operator==(const EncodeUtf16Iter& other) const noexcept -> bool
+            {
+                return this->pos == other.pos && this->low == other.low;
+            }
+
+        private:
+            auto decode() noexcept -> void
+            {
+                if (this->pos >= this->s.len)
+                {
+                    this->len = 0;
+                    return;
+                }
+
+                const auto byte = std::to_integer<std::uint32_t>(this->s.data[this->pos]);
+                if (byte < 0x80)
+                {
+                    this->units = {char16_t(byte), 0};
+                    this->len = 1;
+                    return;
+                }
+
+                const auto [ch, len] = str::decode_char(this->s.data + this->pos, this->s.len - this->pos);
+                const auto cp = ch.code_point();
+                this->len = len;
+
+                if (cp < 0x10000)
+                {
+                    this->units = {char16_t(cp), 0};
+                }
+                else
+                {
+                    this->units = {char16_t(0xD800 + ((cp - 0x10000) >> 10)), char16_t(0xDC00 + ((cp - 0x10000) & 0x3FF))};
+                }
+            }
+        };
+
+        constexpr explicit EncodeUtf16(const plain_str& s) noexcept : s(s) {}
+
+        auto begin() const noexcept -> EncodeUtf16Iter
+        {
+            return EncodeUtf16Iter(this->s, 0);
+        }
+
+        auto end() const noexcept -> EncodeUtf16Iter
+        {
+            return EncodeUtf16Iter(this->s, this->s.len);
+        }
+
+        using iterator = EncodeUtf16Iter;
+        using const_iterator = EncodeUtf16Iter;
+    };
+
+public:
+    /**
+     * @brief Names the view templates of the Pattern searches, for the std::ranges::enable_borrowed_range and
+     * std::ranges::enable_view specializations
+     */
+    template<Pattern P>
+    using PatternMatchesView = PatternMatches<P>;
+
+    template<Pattern P>
+    using PatternSplitView = PatternSplit<P>;
+
+    [[nodiscard]] constexpr auto chars() const noexcept -> Chars
+    {
+        return Chars(plain_str(this->m_data, this->m_len));
+    }
+
+    /**
+     * @brief Returns an iterator over the lines of this string
+     * @return A Lines iterator that yields each line in the string
+     */
+    [[nodiscard]] constexpr auto lines() const noexcept -> Lines
+    {
+        return Lines(plain_str(this->m_data, this->m_len));
+    }
+
+    /**
+     * @brief Returns an iterator that yields index of each match of the pattern in the str
+     * @param pattern The pattern to match against
+     * @return A Matches iterator that yields each match in the string
+     */
+    [[nodiscard]] constexpr auto matches(const str& pattern) const noexcept -> Matches
+    {
+        return Matches(plain_str(this->m_data, this->m_len), plain_str(pattern.m_data, pattern.m_len));
+    }
+
+    template<typename Alloc>
+    [[nodiscard]] constexpr auto matches(const raw::String<Alloc>& pattern) const noexcept -> Matches
+    {
+        return Matches(plain_str(this->m_data, this->m_len), plain_str(pattern.m_data, pattern.m_len));
+    }
+
+    [[nodiscard]] auto matches(const char* pattern) const noexcept -> Matches
+    {
+        const auto s = str::from(pattern).ok().expect_take("Invalid UTF-8 sequence while calling str::split#pattern");
+        return Matches(plain_str(this->m_data, this->m_len), plain_str(s.data(), s.size()));
+    }
+
+    /**
+     * @brief Returns an iterator that splits the string by the given pattern
+     * @param pattern The pattern to split on
+     * @return A Split iterator that yields each part of the split string
+     */
+    [[nodiscard]] constexpr auto split(const str& pattern) const noexcept -> Split
+    {
+        return Split(plain_str(this->m_data, this->m_len), plain_str(pattern.m_data, pattern.m_len));
+    }
+
+    /**
+     * @brief Returns an iterator that splits the string by the given pattern
+     * @param pattern The pattern to split on
+     * @return A Split iterator that yields each part of the split string
+     */
+    template<typename Alloc>
+    [[nodiscard]] constexpr auto split(const raw::String<Alloc>& pattern) const noexcept -> Split
+    {
+        return Split(plain_str(this->m_data, this->m_len), plain_str(pattern.m_data, pattern.m_len));
+    }
+
+    /**
+     * @brief Returns an iterator that splits the string by the given pattern
+     * @param pattern The pattern to split on
+     * @return A Split iterator that yields each part of the split string
+     * @note Panics If the pattern is not a valid UTF-8 sequence
+     */
+    [[nodiscard]] auto split(const char* pattern) const noexcept -> Split
+    {
+        const auto s = str::from(pattern).ok().expect_take("Invalid UTF-8 sequence while calling str::split#pattern");
+        return Split(plain_str(this->m_data, this->m_len), plain_str(s.m_data, s.m_len));
+    }
+
+    /**
+     * @brief Returns an iterator over the byte indices of the matches of a precompiled needle
+     * @param finder The searcher built for the needle, it must outlive the iterator
+     */
+    [[nodiscard]] auto matches(const Finder& finder) const noexcept -> FinderMatches;
+
+    /**
+     * @brief Returns an iterator over the parts of the string split by a precompiled needle, the parts are the same as
+     * str::split yields for the needle
+     * @param finder The searcher built for the needle, it must outlive the iterator
+     */
+    [[nodiscard]] auto split(const Finder& finder) const noexcept -> FinderSplit;
+
+    /**
+     * @brief Returns an iterator over the parts of the string separated by any char of the set, the parts are the same as
+     * str::split yields for a single char delimiter
+     * @param set The delimiter chars
+     */
+    [[nodiscard]] auto split_any(const CharClass& set) const noexcept -> PatternSplit<CharClass>;
+
+    /**
+     * @brief Returns an iterator over the byte indices of the chars that match the pattern
+     * @param pattern The pattern to search for
+     */
+    template<Pattern P>
+    [[nodiscard]] auto matches(const P& pattern) const noexcept -> PatternMatches<P>
+    {
+        return PatternMatches<P>(plain_str(this->m_data, this->m_len), pattern);
+    }
+
+    /**
+     * @brief Returns an iterator over the parts of the string separated by chars that match the pattern
+     * @param pattern The pattern to split on
+     */
+    template<Pattern P>
+    [[nodiscard]] auto split(const P& pattern) const noexcept -> PatternSplit<P>
+    {
+        return PatternSplit<P>(plain_str(this->m_data, this->m_len), pattern);
+    }
+
+    /**
+     * @brief Splits the string on the first occurrence of the delimiter
+     * @param delimiter The delimiter to split on, an empty delimiter never matches
+     * @return The parts before and after the delimiter, or None if the delimiter is not found
+     */
+    [[nodiscard]] auto split_once(const str& delimiter) const noexcept -> Option<std::pair<str, str>>
+    {
+        const size_t pos = this->find_from(delimiter, 0);
+        if (pos == this->m_len)
+        {
+            return None{};
+        }
+
+        const size_t end = pos + delimiter.m_len;
+        return std::pair(str(this->m_data, pos), str(this->m_data + end, this->m_len - end));
+    }
+
+    /**
+     * @see str::split_once(const str&)
+     * @note Panics If the delimiter is not a valid UTF-8 sequence
+     */
+    [[nodiscard]] auto split_once(const char* delimiter) const noexcept -> Option<std::pair<str, str>>
+    {
+        return this->split_once(str::from(delimiter).ok().expect_take("Invalid UTF-8 sequence while calling str::split_once#delimiter"));
+    }
+
+    /**
+     * @brief Splits the string on the last occurrence of the delimiter
+     * @param delimiter The delimiter to split on, an empty delimiter never matches
+     * @return The parts before and after the delimiter, or None if the delimiter is not found
+     */
+    [[nodiscard]] auto rsplit_once(const str& delimiter) const noexcept -> Option<std::pair<str, str>>
+    {
+        const auto pos = this->rfind_last(delimiter);
+        if (pos.is_none())
+        {
+            return None{};
+        }
+
+        const size_t end = pos.unwrap() + delimiter.m_len;
+        return std::pair(str(this->m_data, pos.unwrap()), str(this->m_data + end, this->m_len - end));
+    }
+
+    /**
+     * @see str::rsplit_once(const str&)
+     * @note Panics If the delimiter is not a valid UTF-8 sequence
+     */
+    [[nodiscard]] auto rsplit_once(const char* delimiter) const noexcept -> Option<std::pair<str, str>>
+    {
+        return this->rsplit_once(str::from(delimiter).ok().expect_take("Invalid UTF-8 sequence while calling str::rsplit_once#delimiter"));
+    }
+
+    /**
+     * @brief Returns an iterator over at most n parts of the string split by the pattern, the last part holds the
+     * remainder of the string
+     * @param n The maximum number of parts
+     * @param pattern The pattern to split on, an empty pattern never matches
+     */
+    [[nodiscard]] auto splitn(size_t n, const str& pattern) const noexcept -> SplitPieces<SplitKind::N>
+    {
+        return SplitPieces<SplitKind::N>(plain_str(this->m_data, this->m_len), plain_str(pattern.m_data, pattern.m_len), n);
+    }
+
+    /**
+     * @see str::splitn(size_t, const str&)
+     * @note Panics If the pattern is not a valid UTF-8 sequence
+     */
+    [[nodiscard]] auto splitn(size_t n, const char* pattern) const noexcept -> SplitPieces<SplitKind::N>
+    {
+        return this->splitn(n, str::from(pattern).ok().expect_take("Invalid UTF-8 sequence while calling str::splitn#pattern"));
+    }
+
+    /**
+     * @brief Returns an iterator over at most n parts of the string split by the pattern, starting from the end of the
+     * string, the last part holds the remainder of the string
+     * @param n The maximum number of parts
+     * @param pattern The pattern to split on, an empty pattern never matches
+     */
+    [[nodiscard]] auto rsplitn(size_t n, const str& pattern) const noexcept -> SplitPieces<SplitKind::ReverseN>
+    {
+        return SplitPieces<SplitKind::ReverseN>(plain_str(this->m_data, this->m_len), plain_str(pattern.m_data, pattern.m_len), n);
+    }
+
+    /**
+     * @see str::rsplitn(size_t, const str&)
+     * @note Panics If the pattern is not a valid UTF-8 sequence
+     */
+    [[nodiscard]] auto rsplitn(size_t n, const char* pattern) const noexcept -> SplitPieces<SplitKind::ReverseN>
+    {
+        return this->rsplitn(n, str::from(pattern).ok().expect_take("Invalid UTF-8 sequence while calling str::rsplitn#pattern"));
+    }
+
+    /**
+     * @brief Returns an iterator over the parts of the string split by the pattern, where the pattern terminates each
+     * part instead of separating them: the empty part after a trailing pattern is skipped, and an empty string has no parts
+     * @param pattern The pattern to split on, an empty pattern never matches
+     */
+    [[nodiscard]] auto split_terminator(const str& pattern) const noexcept -> SplitPieces<SplitKind::Terminator>
+    {
+        return SplitPieces<SplitKind::Terminator>(plain_str(this->m_data, this->m_len), plain_str(pattern.m_data, pattern.m_len), 1);
+    }
+
+    /**
+     * @see str::split_terminator(const str&)
+     * @note Panics If the pattern is not a valid UTF-8 sequence
+     */
+    [[nodiscard]] auto split_terminator(const char* pattern) const noexcept -> SplitPieces<SplitKind::Terminator>
+    {
+        return this->split_terminator(str::from(pattern).ok().expect_take("Invalid UTF-8 sequence while calling str::split_terminator#pattern"));
+    }
+
+    /**
+     * @brief Returns an iterator over the parts of the string split by the pattern, each part keeps its trailing pattern
+     * @param pattern The pattern to split on, an empty pattern never matches
+     */
+    [[nodiscard]] auto split_inclusive(const str& pattern) const noexcept -> SplitPieces<SplitKind::Inclusive>
+    {
+        return SplitPieces<SplitKind::Inclusive>(plain_str(this->m_data, this->m_len), plain_str(pattern.m_data, pattern.m_len), 0);
+    }
+
+    /**
+     * @see str::split_inclusive(const str&)
+     * @note Panics If the pattern is not a valid UTF-8 sequence
+     */
+    [[nodiscard]] auto split_inclusive(const char* pattern) const noexcept -> SplitPieces<SplitKind::Inclusive>
+    {
+        return this->split_inclusive(str::from(pattern).ok().expect_take("Invalid UTF-8 sequence while calling str::split_inclusive#pattern"));
+    }
+
+    /**
+     * @brief Returns an iterator that splits the string by ASCII whitespaces
+     * @return A SplitASCIIWhiteSpace iterator that yields each part of the split string
+     */
+    [[nodiscard]] constexpr auto split_ascii_whitespace() const noexcept -> SplitASCIIWhiteSpace
+    {
+       return SplitASCIIWhiteSpace(plain_str(this->m_data, this->m_len));
+    }
+
+    /**
+     * @brief Returns an iterator that yields each grapheme in the string
+     * @return A Graphemes iterator that yields each grapheme in the string
+     */
+    [[nodiscard]] constexpr auto graphemes() const noexcept -> Graphemes
+    {
+        return Graphemes(plain_str(this->m_data, this->m_len));
+    }
+
+    /**
+     * @brief Returns an iterator over the UTF-16 code units of the string
+     * @return An EncodeUtf16 iterator that yields each code unit
+     */
+    [[nodiscard]] constexpr auto encode_utf16() const noexcept -> EncodeUtf16
+    {
+        return EncodeUtf16(plain_str(this->m_data, this->m_len));
+    }
+
+    /**
+     * @brief Returns the number of UTF-16 code units needed to encode the string
+     */
+    [[nodiscard]] auto utf16_len() const noexcept -> size_t
+    {
+        return transcode::utf16_len_of_utf8(this->m_data, this->m_len);
+    }
+
+    /**
+     * @brief Appends the UTF-16 encoding of the string to out, out grows exactly once
+     * @param out The string to append to
+     */
+    auto to_utf16(std::u16string& out) const -> void
+    {
+        const size_t len = this->utf16_len();
+
+        out.resize_and_overwrite(out.size() + len, [this, len](char16_t* buffer, size_t size)
+        {
+            transcode::utf8_to_utf16(this->m_data, this->m_len, buffer + size - len);
+            return size;
+        });
+    }
+
+// operators
+public:
+    [[nodiscard]] constexpr auto operator<=>(const str& other) const noexcept -> std::strong_ordering
+    {
+        // If both strings are empty, they are equal
+        if (this->m_len == 0 && other.m_len == 0)
+        {
+            return std::strong_ordering::equal;
+        }
+
+        // If this string is empty, it's less than any non-empty string
+        if (this->m_len == 0)
+        {
+            return std::strong_ordering::less;
+        }
+
+        // If other string is empty, this string is greater
+        if (other.m_len == 0)
+        {
+            return std::strong_ordering::greater;
+        }
+
+        // Compare byte by byte until we find a difference
+        const size_t min_len = std::min(this->m_len, other.m_len);
+        for (size_t i = 0; i < min_len; ++i)
+        {
+            if (this->m_data[i] != other.m_data[i])
+            {
+                return this->m_data[i] <=> other.m_data[i];
+            }
+        }
+
+        // If we get here, one string is a prefix of the other
+        // The shorter string is considered less
+        return this->m_len <=> other.m_len;
+    }
+
+    [[nodiscard]] constexpr auto operator==(const str& other) const noexcept -> bool
+    {
+        if (this->m_len != other.m_len)
+        {
+            return false;
+        }
+        return std::equal(this->m_data, this->m_data + this->m_len, other.m_data);
+    }
+};
+
+/**
+ * @brief A substring searcher built once for a needle and reused across many haystacks.
+ * Building it copies the needle, computes the Two-Way critical factorization and bad byte shift table, and picks the
+ * rarest byte of the needle, which is located with memchr to skip ahead before a candidate position is verified.
+ * A Finder is immutable once built, so it can be copied and shared across threads.
+ * An empty needle never matches, consistent with str::find.
+ */
+struct Finder
+{
+private:
+    std::vector<std::byte> m_needle;
+    TwoWay m_two_way;
+    size_t m_rare = 0;
+
+public:
+    /**
+     * @brief Builds a searcher for the needle
+     * @param needle The str to search for
+     */
+    explicit Finder(const str& needle) : m_needle(needle.data(), needle.data() + needle.size()),
+        m_two_way(needle.data(), needle.size())
+    {
+        for (size_t i = 1; i < this->m_needle.size(); i += 1)
+        {
+            if (byte_rank(std::to_integer<std::uint8_t>(this->m_needle[i])) < byte_rank(std::to_integer<std::uint8_t>(this->m_needle[this->m_rare])))
+            {
+                this->m_rare = i;
+            }
+        }
+    }
+
+    /**
+     * @return The needle this searcher was built for
+     */
+    [[nodiscard]] auto needle() const noexcept -> str
+    {
+        return str::from_bytes_unchecked(this->m_needle.data(), this->m_needle.size());
+    }
+
+    /**
+     * @brief Returns the byte index of the first match in the haystack
+     * @param haystack The str to search
+     * @return Option containing the byte index of the first match, or None if not found
+     */
+    [[nodiscard]] auto find(const str& haystack) const noexcept -> Option<size_t>
+    {
+        return this->find_at(haystack, 0);
+    }
+
+    /**
+     * @brief Returns the byte index of the first match in the haystack that starts at or after from
+     * @param haystack The str to search
+     * @param from The byte index to start searching at
+     * @return Option containing the byte index of the match, or None if not found
+     */
+    [[nodiscard]] auto find_at(const str& haystack, size_t from) const noexcept -> Option<size_t>
+    {
+        const size_t len = this->m_needle.size();
+        if (len == 0 || from > haystack.size() || haystack.size() - from < len)
+        {
+            return None{};
+        }
+
+        const auto data = haystack.data();
+        const auto rare = std::to_integer<int>(this->m_needle[this->m_rare]);
+
+        // memchr on the rare byte pays off while it skips far enough, once it stops doing so the shift table takes over
+        size_t skips = 0;
+        size_t skipped = 0;
+
+        const auto skip = [&](size_t pos) -> size_t
+        {
+            if (skips >= 32 && skipped < skips * 8)
+            {
+                return pos;
+            }
+
+            const auto ptr = static_cast<const std::byte*>(std::memchr(data + pos + this->m_rare, rare, haystack.size() - len - pos + 1));
+            if (ptr == nullptr)
+            {
+                return haystack.size();
+            }
+
+            const size_t next = size_t(ptr - data) - this->m_rare;
+            skips += 1;
+            skipped += next - pos;
+
+            return next;
+        };
+
+        const size_t pos = this->m_two_way.search(this->m_needle.data(), len, haystack.size(), from, [&](size_t i) { return data[i]; }, skip);
+        if (pos == haystack.size())
+        {
+            return None{};
+        }
+
+        return pos;
+    }
+};
+
+/**
+ * @brief A substring searcher like Finder that finds the last match instead of the first one.
+ * It runs the Two-Way algorithm over the reversed needle and haystack.
+ */
+struct FinderRev
+{
+private:
+    std::vector<std::byte> m_needle;
+    TwoWay m_two_way;
+
+public:
+    /**
+     * @brief Builds a searcher for the needle
+     * @param needle The str to search for
+     */
+    explicit FinderRev(const str& needle) : m_needle(std::make_reverse_iterator(needle.data() + needle.size()), std::make_reverse_iterator(needle.data())),
+        m_two_way(this->m_needle.data(), this->m_needle.size()) {}
+
+    /**
+     * @brief Returns the byte index of the last match in the haystack
+     * @param haystack The str to search
+     * @return Option containing the byte index of the last match, or None if not found
+     */
+    [[nodiscard]] auto rfind(const str& haystack) const noexcept -> Option<size_t>
+    {
+        const size_t len = this->m_needle.size();
+        if (len == 0 || haystack.size() < len)
+        {
+            return None{};
+        }
+
+        const auto data = haystack.data();
+        const size_t last = haystack.size() - 1;
+
+        const size_t pos = this->m_two_way.search(this->m_needle.data(), len, haystack.size(), 0, [&](size_t i) { return data[last - i]; }, [](size_t pos) { return pos; });
+        if (pos == haystack.size())
+        {
+            return None{};
+        }
+
+        return haystack.size() - pos - len;
+    }
+};
+
+/**
+ * @brief The iterator of str::matches for a Finder, it yields the byte index of each match.
+ * The iterators point to the caller's Finder rather than into the view, so they stay valid after the view is gone.
+ */
+struct FinderMatches
+{
+    struct FinderMatchesIter
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = size_t;
+        using pointer = const size_t*;
+        using reference = const size_t&;
+
+        const Finder* finder = nullptr;
+        str s;
+        size_t match_pos = 0;
+        bool done = true;
+
+        constexpr FinderMatchesIter() noexcept = default;
+
+        FinderMatchesIter(const Finder* finder, const str& s) noexcept : finder(finder), s(s), done(false)
+        {
+            this->advance(0);
+        }
+
+        [[nodiscard]] auto operator*() const noexcept -> reference
+        {
+            return this->match_pos;
+        }
+
+        [[nodiscard]] auto operator->() const noexcept -> pointer
+        {
+            return &this->match_pos;
+        }
+
+        auto operator++() noexcept -> FinderMatchesIter&
+        {
+            if (!this->done)
+            {
+                this->advance(this->match_pos + this->finder->needle().size());
+            }
+
+            return *this;
+        }
+
+        auto operator++(int) noexcept -> FinderMatchesIter
+        {
+            auto temp = *this;
+            ++(*this);
+
+            return temp;
+        }
+
+        [[nodiscard]] auto operator==(const FinderMatchesIter& other) const noexcept -> bool
+        {
+            return this->done == other.done && (this->done || this->match_pos == other.match_pos);
+        }
+
+    private:
+        auto advance(size_t from) noexcept -> void
+        {
+            const auto pos = this->finder->find_at(this->s, from);
+            if (pos.is_none())
+            {
+                this->done = true;
+                return;
+            }
+
+            this->match_pos = pos.unwrap();
+        }
+    };
+
+public:
+    using iterator = FinderMatchesIter;
+    using const_iterator = FinderMatchesIter;
+
+    str s;
+    const Finder* finder;
+
+public:
+    FinderMatches(const str& s, const Finder& finder) noexcept : s(s), finder(&finder) {}
+
+public:
+    [[nodiscard]] auto begin() const noexcept -> FinderMatchesIter
+    {
+        return FinderMatchesIter(this->finder, this->s);
+    }
+
+    [[nodiscard]] auto end() const noexcept -> FinderMatchesIter
+    {
+        return FinderMatchesIter();
+    }
+};
+
+/**
+ * @brief The iterator of str::split for a Finder, it yields the same parts as str::split does for the needle.
+ * The iterators point to the caller's Finder rather than into the view, so they stay valid after the view is gone.
+ */
+struct FinderSplit
+{
+    struct FinderSplitIter
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = str;
+        using pointer = const str*;
+        using reference = const str&;
+
+        const Finder* finder = nullptr;
+        str s;
+        str current;
+        size_t next = 0;
+        bool done = true;
+
+        constexpr FinderSplitIter() noexcept = default;
+
+        FinderSplitIter(const Finder* finder, const str& s) noexcept : finder(finder), s(s), done(false)
+        {
+            this->advance(0);
+        }
+
+        [[nodiscard]] auto operator*() const noexcept -> reference
+        {
+            return this->current;
+        }
+
+        [[nodiscard]] auto operator->() const noexcept -> pointer
+        {
+            return &this->current;
+        }
+
+        auto operator++() noexcept -> FinderSplitIter&
+        {
+            if (this->done)
             {
-                return this->s == other.s;
+                return *this;
             }
-        };
 
-        const str* s;
-        plain_str pattern;
+            // Like str::split, the empty part after a trailing delimiter is not yielded
+            if (this->next >= this->s.size())
+            {
+                this->done = true;
+                return *this;
+            }
 
-        constexpr Matches(const str& s, const plain_str& pattern) noexcept : s(&s), pattern(pattern) {}
+            this->advance(this->next);
+            return *this;
+        }
 
-        [[nodiscard]] constexpr auto begin() const noexcept -> MatchesIter
+        auto operator++(int) noexcept -> FinderSplitIter
         {
-            return MatchesIter(this->s, this->pattern);
+            auto temp = *this;
+            ++(*this);
+
+            return temp;
         }
 
-        [[nodiscard]] constexpr auto end() const noexcept -> MatchesIter
+        [[nodiscard]] auto operator==(const FinderSplitIter& other) const noexcept -> bool
         {
-            return MatchesIter(nullptr, this->pattern);
+            return this->done == other.done &&
+                (this->done || (this->current.data() == other.current.data() && this->current.size() == other.current.size()));
         }
 
-        using iterator = MatchesIter;
-        using const_iterator = MatchesIter;
+    private:
+        auto advance(size_t from) noexcept -> void
+        {
+            const auto pos = this->finder->find_at(this->s, from);
+            const size_t end = pos.is_some() ? pos.unwrap() : this->s.size();
+
+            this->current = str::from_bytes_unchecked(this->s.data() + from, end - from);
+            this->next = pos.is_some() ? end + this->finder->needle().size() : this->s.size() + 1;
+        }
     };
 
-    struct Split
+public:
+    using iterator = FinderSplitIter;
+    using const_iterator = FinderSplitIter;
+
+    str s;
+    const Finder* finder;
+
+public:
+    FinderSplit(const str& s, const Finder& finder) noexcept : s(s), finder(&finder) {}
+
+public:
+    [[nodiscard]] auto begin() const noexcept -> FinderSplitIter
     {
-        struct SplitIter
+        return FinderSplitIter(this->finder, this->s);
+    }
+
+    [[nodiscard]] auto end() const noexcept -> FinderSplitIter
+    {
+        return FinderSplitIter();
+    }
+};
+
+inline auto str::find(const Finder& finder) const noexcept -> Option<size_t>
+{
+    return finder.find(*this);
+}
+
+inline auto str::rfind(const FinderRev& finder) const noexcept -> Option<size_t>
+{
+    return finder.rfind(*this);
+}
+
+inline auto str::matches(const Finder& finder) const noexcept -> FinderMatches
+{
+    return FinderMatches(*this, finder);
+}
+
+inline auto str::split(const Finder& finder) const noexcept -> FinderSplit
+{
+    return FinderSplit(*this, finder);
+}
+
+template<typename Alloc>
+auto str::replace(const Finder& finder, const str& replacement) const -> raw::String<Alloc>
+{
+    auto string = raw::String<Alloc>();
+    string.reserve(this->m_len);
+
+    size_t pos = 0;
+    for (auto found = finder.find_at(*this, 0); found.is_some(); found = finder.find_at(*this, pos))
+    {
+        string.push_str(str::from_bytes_unchecked(this->m_data + pos, found.unwrap() - pos));
+        string.push_str(replacement);
+        pos = found.unwrap() + finder.needle().size();
+    }
+
+    string.push_str(str::from_bytes_unchecked(this->m_data + pos, this->m_len - pos));
+    return string;
+}
+
+/**
+ * @brief A set of chars, such as the delimiters of a tokenizer, that str searches test any char against.
+ * It keeps a 256 bit table of the bytes that start a member: the ASCII members themselves, and the UTF-8 lead bytes of
+ * the other members. Searching tests each byte against the table, so ASCII sets never decode the haystack, and other
+ * sets decode only at bytes that can start a member.
+ * The table is built by a constexpr constructor, so a set can be built at compile time or at run time.
+ * A CharClass borrows the chars it was built from.
+ */
+struct CharClass
+{
+private:
+    std::array<std::uint64_t, 4> m_table{};
+    str m_chars;
+    bool m_ascii = true;
+
+public:
+    /**
+     * @brief Builds a set of the chars of a str, duplicates are allowed
+     * @param chars The member chars
+     */
+    constexpr CharClass(const str& chars) noexcept : m_chars(chars)
+    {
+        for (const auto byte : chars.as_bytes())
         {
-            using iterator_category = std::forward_iterator_tag;
-            using difference_type = std::ptrdiff_t;
-            using value_type = plain_str;
-            using pointer = const plain_str*;
-            using reference = const plain_str&;
+            const auto value = std::to_integer<std::uint8_t>(byte);
 
-            const str* s = nullptr;
-            plain_str pattern;
-            plain_str span;
+            // Continuation bytes never start a char
+            if ((value & 0xC0) != 0x80)
+            {
+                this->m_table[value / 64] |= std::uint64_t(1) << (value % 64);
+                this->m_ascii = this->m_ascii && value < 0x80;
+            }
+        }
+    }
 
-            constexpr SplitIter() noexcept = default;
+    /**
+     * @return The chars of this set
+     */
+    [[nodiscard]] constexpr auto chars() const noexcept -> str
+    {
+        return this->m_chars;
+    }
+
+    /**
+     * @return true if every char of this set is ASCII
+     */
+    [[nodiscard]] constexpr auto is_ascii() const noexcept -> bool
+    {
+        return this->m_ascii;
+    }
+
+    /**
+     * @return true if the char is in this set
+     */
+    [[nodiscard]] auto contains(const Char& ch) const noexcept -> bool
+    {
+        if (ch.is_ascii())
+        {
+            return this->may_start(static_cast<std::uint8_t>(ch.code_point()));
+        }
+
+        std::array<std::byte, 4> encoded{};
+        const auto len = utf8proc_encode_char(static_cast<utf8proc_int32_t>(ch.code_point()), reinterpret_cast<utf8proc_uint8_t*>(encoded.data()));
+
+        return this->may_start(std::to_integer<std::uint8_t>(encoded[0])) &&
+            this->m_chars.contains(str::from_bytes_unchecked(encoded.data(), size_t(len)));
+    }
+
+    /**
+     * @brief Returns the byte index of the first char in this set, starting at from
+     * @param haystack The str to search
+     * @param from The byte index to start searching at, it must be on a char boundary
+     * @return Option containing the byte index of the match, or None if not found
+     */
+    [[nodiscard]] auto find_at(const str& haystack, size_t from) const noexcept -> Option<size_t>
+    {
+        const auto data = haystack.data();
 
-            constexpr SplitIter(const str* s, const plain_str& pattern) noexcept : s(s), pattern(pattern)
+        for (size_t pos = from; pos < haystack.size(); pos += 1)
+        {
+            const auto byte = std::to_integer<std::uint8_t>(data[pos]);
+            if (!this->may_start(byte))
             {
-                if (s != nullptr)
-                {
-                    // If pattern is empty, return the entire string
-                    if (pattern.len == 0)
-                    {
-                        span = plain_str(s->m_data, s->m_len);
-                        return;
-                    }
+                continue;
+            }
 
-                    auto ptr = std::search(this->s->m_data, this->s->m_data + this->s->m_len, this->pattern.data, this->pattern.data + this->pattern.len);
-                    if (ptr != this->s->m_data + this->s->m_len)
-                    {
-                        const auto pos = ptr - this->s->m_data;
-                        this->span = plain_str(s->m_data, size_t(pos));
-                    }
-                    else
-                    {
-                        span = plain_str(s->m_data, s->m_len);
-                    }
+            if (byte < 0x80 || this->contains_char_at(haystack, pos))
+            {
+                return pos;
+            }
+        }
+
+        return None{};
+    }
+
+    /**
+     * @brief Returns the byte index of the first char not in this set, starting at from
+     * @param haystack The str to search
+     * @param from The byte index to start searching at, it must be on a char boundary
+     * @return Option containing the byte index of the first char outside the set, or None if there is none
+     */
+    [[nodiscard]] auto find_not_at(const str& haystack, size_t from) const noexcept -> Option<size_t>
+    {
+        const auto data = haystack.data();
+
+        for (size_t pos = from; pos < haystack.size();)
+        {
+            const auto byte = std::to_integer<std::uint8_t>(data[pos]);
+            if (byte < 0x80)
+            {
+                if (!this->may_start(byte))
+                {
+                    return pos;
                 }
+
+                pos += 1;
+                continue;
             }
 
-            [[nodiscard]] auto operator->() const noexcept -> const plain_str*
+            const size_t len = CharClass::char_len(byte);
+            if (!this->may_start(byte) || !this->contains_char_at(haystack, pos))
             {
-                return &this->span;
+                return pos;
             }
 
-            [[nodiscard]] auto operator*() const noexcept -> const plain_str&
+            pos += len;
+        }
+
+        return None{};
+    }
+
+private:
+    [[nodiscard]] constexpr auto may_start(std::uint8_t byte) const noexcept -> bool
+    {
+        return (this->m_table[byte / 64] >> (byte % 64) & 1) != 0;
+    }
+
+    [[nodiscard]] static constexpr auto char_len(std::uint8_t lead) noexcept -> size_t
+    {
+        return lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+    }
+
+    /**
+     * @brief Checks if the non ASCII char starting at pos is in this set, it is a substring search of the set itself
+     */
+    [[nodiscard]] auto contains_char_at(const str& haystack, size_t pos) const noexcept -> bool
+    {
+        const size_t len = CharClass::char_len(std::to_integer<std::uint8_t>(haystack.data()[pos]));
+        return this->m_chars.contains(str::from_bytes_unchecked(haystack.data() + pos, len));
+    }
+};
+
+inline auto str::find_any_of(const CharClass& set) const noexcept -> Option<size_t>
+{
+    return set.find_at(*this, 0);
+}
+
+inline auto str::find_not_of(const CharClass& set) const noexcept -> Option<size_t>
+{
+    return set.find_not_at(*this, 0);
+}
+
+inline auto str::split_any(const CharClass& set) const noexcept -> PatternSplit<CharClass>
+{
+    return PatternSplit<CharClass>(plain_str(this->m_data, this->m_len), set);
+}
+
+namespace strings
+{
+    /**
+     * @brief Parses every item of a range of strings, such as the one returned by str::split
+     * @tparam T The numeric type to parse into
+     * @param items The strings to parse
+     * @return A Result containing either all the parsed values in order, or the error of the first item that failed
+     */
+    template<typename T, std::ranges::input_range R>
+        requires (std::integral<T> || std::floating_point<T>) && std::convertible_to<std::ranges::range_reference_t<R>, str>
+    [[nodiscard]] auto parse_all(R&& items) -> Result<std::vector<T>, ParseAllError>
+    {
+        auto values = std::vector<T>();
+        if constexpr (std::ranges::sized_range<R>)
+        {
+            values.reserve(std::ranges::size(items));
+        }
+
+        size_t index = 0;
+        for (auto&& item : items)
+        {
+            const auto result = static_cast<str>(item).template parse<T>();
+            if (result.is_err())
             {
-                return this->span;
+                return ParseAllError(index, result.unwrap_err().ec);
             }
 
-            constexpr auto operator++() noexcept -> SplitIter&
+            values.push_back(result.unwrap());
+            index += 1;
+        }
+
+        return values;
+    }
+
+    /**
+     * @brief Joins the strings of a range into a new String, putting the separator between every two of them.
+     * The lengths are summed first, so the result is allocated once and no piece is validated again.
+     * @param items The strings to join
+     * @param separator The separator
+     * @param alloc The allocator of the result
+     * @return The joined String
+     * @note Panics if the total length overflows size_t
+     */
+    template<typename Alloc = std::allocator<std::byte>, std::ranges::forward_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, str>
+    [[nodiscard]] auto join(R&& items, const str& separator, const Alloc& alloc = Alloc()) -> raw::String<Alloc>
+    {
+        size_t total = 0;
+        bool first = true;
+
+        for (auto&& item : items)
+        {
+            const size_t len = static_cast<str>(item).size() + (first ? 0 : separator.size());
+            if (len > std::numeric_limits<size_t>::max() - total)
             {
-                if (this->s == nullptr)
-                {
-                    return *this;
-                }
+                panic("Capacity overflow while calling strings::join");
+            }
 
-                size_t start = span.data - this->s->m_data + span.len;
+            total += len;
+            first = false;
+        }
 
-                // Skip the delimiter
-                start += pattern.len;
+        auto result = raw::String<Alloc>(alloc);
+        result.reserve(total);
+        first = true;
 
-                // If reached the end after skipping delimiter, end iteration
-                if (start >= this->s->m_len)
-                {
-                    this->s = nullptr;
-                    this->span.len = 0;
-                    return *this;
-                }
+        for (auto&& item : items)
+        {
+            if (!first)
+            {
+                result.push_str(separator);
+            }
+
+            result.push_str(static_cast<str>(item));
+            first = false;
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Joins the strings of a range into a new String, putting the separator between every two of them
+     * @note Panics if the separator is not a valid UTF-8 sequence, or if the total length overflows size_t
+     */
+    template<typename Alloc = std::allocator<std::byte>, std::ranges::forward_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, str>
+    [[nodiscard]] auto join(R&& items, const char* separator, const Alloc& alloc = Alloc()) -> raw::String<Alloc>
+    {
+        const auto s = str::from(separator).expect("Invalid UTF-8 sequence while calling strings::join#separator");
+        return strings::join<Alloc>(std::forward<R>(items), s, alloc);
+    }
+
+    /**
+     * @brief Concatenates the given strings into a new String that uses the given allocator, allocating once for their
+     * total length
+     * @param alloc The allocator to use
+     * @param parts The strings to concatenate
+     * @return The concatenated String
+     * @note Panics if the total length overflows size_t
+     */
+    template<typename Alloc, typename... S>
+        requires (std::convertible_to<const S&, str> && ...)
+    [[nodiscard]] auto concat_in(const Alloc& alloc, const S&... parts) -> raw::String<Alloc>
+    {
+        const auto pieces = std::array<str, sizeof...(S)>{static_cast<str>(parts)...};
+        size_t total = 0;
+
+        for (const auto& piece : pieces)
+        {
+            if (piece.size() > std::numeric_limits<size_t>::max() - total)
+            {
+                panic("Capacity overflow while calling strings::concat");
+            }
+
+            total += piece.size();
+        }
+
+        auto result = raw::String<Alloc>(alloc);
+        result.reserve(total);
+
+        for (const auto& piece : pieces)
+        {
+            result.push_str(piece);
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Concatenates the given strings into a new String, allocating once for their total length
+     * @param parts The strings to concatenate
+     * @return The concatenated String
+     * @note Panics if the total length overflows size_t
+     */
+    template<typename Alloc = std::allocator<std::byte>, typename... S>
+        requires (std::convertible_to<const S&, str> && ...)
+    [[nodiscard]] auto concat(const S&... parts) -> raw::String<Alloc>
+    {
+        return strings::concat_in(Alloc(), parts...);
+    }
+
+    constexpr auto join_with(char ch) -> decltype(auto)
+    {
+        return std::views::join_with(static_cast<std::byte>(ch));
+    }
+
+    auto join_with(const char* str) -> decltype(auto)
+    {
+        const auto s = str::from(str).expect("Invalid UTF-8 sequence while calling strings::join_with#str");
+        return std::views::join_with(s.as_bytes());
+    }
+
+    constexpr auto join_with(const str& str) -> decltype(auto)
+    {
+        return std::views::join_with(str.as_bytes());
+    }
+
+    template<typename Alloc = std::allocator<std::byte>>
+    constexpr auto join_with(const raw::String<Alloc>& str) -> decltype(auto)
+    {
+        return std::views::join_with(str.as_bytes());
+    }
+}
 
-                // Find the next split point
-                const auto ptr = std::search(this->s->m_data + start, this->s->m_data + this->s->m_len, this->pattern.data, this->pattern.data + this->pattern.len);
-                const auto pos = ptr - this->s->m_data;
-                this->span = plain_str(this->s->m_data + start, pos - start);
+/**
+ * @brief A range of bytes that raw::String can be created from: a view, or a sized range such as a std::vector or a
+ * std::deque. Sized ranges grow the buffer once, contiguous ones are copied with memcpy.
+ * str and the string types are left to their own constructors.
+ */
+template<typename R>
+concept ByteRange = !std::same_as<std::remove_cvref_t<R>, str> && !requires(const R& r) { r.as_str(); } &&
+    std::ranges::input_range<R> && std::same_as<std::ranges::range_value_t<R>, std::byte> &&
+    (std::ranges::view<std::remove_reference_t<R>> || std::ranges::sized_range<R>);
 
-                return *this;
-            }
+namespace raw
+{
 
-            constexpr auto operator++(int) noexcept -> SplitIter
-            {
-                SplitIter temp = *this;
-                ++(*this);
-                return temp;
-            }
+/**
+ * @brief A UTF-8 encoded, null-terminated, growable string with custom allocator support
+ * @tparam Alloc The allocator type to use for memory management
+ */
+template<typename Alloc = std::allocator<std::byte>>
+struct String
+{
+    using pointer = typename std::allocator_traits<Alloc>::pointer;
+    friend struct crab_cpp::str;
 
-            [[nodiscard]] constexpr auto operator==(const SplitIter& other) const noexcept -> bool
-            {
-                return (this->s == other.s) && (this->pattern == other.pattern);
-            }
-        };
+private:
+    pointer m_data = nullptr;
+    size_t m_len = 0;
+    compressed_pair<Alloc, size_t> m_alloc_and_capacity;
 
-    public:
-        using iterator = SplitIter;
-        using const_iterator = SplitIter;
+    /**
+     * @brief Private constructor for internal use
+     */
+    String(const Alloc& alloc, pointer data, size_t len, size_t capacity) noexcept
+        : m_data(data), m_len(len), m_alloc_and_capacity(alloc, capacity) {}
 
-        const str* s;
-        plain_str pattern;
+    /**
+     * @brief Whether the buffer is managed with malloc and realloc instead of the allocator.
+     * std::allocator cannot grow a block in place, realloc can, and for large blocks it remaps pages instead of copying.
+     */
+    static constexpr bool uses_malloc = std::same_as<Alloc, std::allocator<std::byte>>;
 
-    public:
-        constexpr Split(const str& s, const plain_str& pattern) noexcept : s(&s), pattern(pattern) {}
+    /**
+     * @brief Allocates room for capacity bytes and the null terminator
+     * @return The buffer and its capacity, which is larger than requested when the allocator hands out a bigger block
+     */
+    [[nodiscard]] static auto allocate_buffer(Alloc& alloc, size_t capacity) -> std::pair<pointer, size_t>
+    {
+        if constexpr (uses_malloc)
+        {
+            const auto data = static_cast<pointer>(std::malloc(capacity + 1));
+            if (data == nullptr)
+            {
+                throw std::bad_alloc();
+            }
 
-    public:
-        [[nodiscard]] constexpr auto begin() const noexcept -> SplitIter
+            return std::pair(data, capacity);
+        }
+        else if constexpr (requires { std::allocator_traits<Alloc>::allocate_at_least(alloc, capacity); })
         {
-            return SplitIter(this->s, this->pattern);
+            const auto result = std::allocator_traits<Alloc>::allocate_at_least(alloc, capacity + 1);
+            return std::pair(result.ptr, size_t(result.count - 1));
         }
-
-        [[nodiscard]] constexpr auto end() const noexcept -> SplitIter
+        else
         {
-            return SplitIter(nullptr, this->pattern);
+            return std::pair(std::allocator_traits<Alloc>::allocate(alloc, capacity + 1), capacity);
         }
-    };
+    }
 
-    struct SplitASCIIWhiteSpace
+    /**
+     * @brief Frees a buffer returned by allocate_buffer
+     */
+    static auto deallocate_buffer(Alloc& alloc, pointer data, size_t capacity) noexcept -> void
     {
-    public:
-        const str* s = nullptr;
+        if constexpr (uses_malloc)
+        {
+            std::free(data);
+        }
+        else
+        {
+            std::allocator_traits<Alloc>::deallocate(alloc, data, capacity + 1);
+        }
+    }
 
-        struct SplitASCIIWhiteSpaceIter
+    /**
+     * @brief Allocates memory for the string
+     * @param capacity The capacity to allocate in bytes
+     */
+    auto allocate(size_t capacity) -> void
+    {
+        if (capacity == 0)
         {
-            using iterator_category = std::forward_iterator_tag;
-            using difference_type = std::ptrdiff_t;
-            using value_type = plain_str;
-            using pointer = const plain_str*;
-            using reference = const plain_str&;
+            this->m_data = nullptr;
+            this->m_alloc_and_capacity.second = 0;
+            return;
+        }
 
-        public:
-            const str* s = nullptr;
-            plain_str span;
-            size_t pos = 0;
+        std::tie(this->m_data, this->m_alloc_and_capacity.second) = String::allocate_buffer(this->m_alloc_and_capacity.first(), capacity);
+        // Add null terminator
+        this->m_data[0] = std::byte{0};
+    }
 
-            constexpr explicit SplitASCIIWhiteSpaceIter() noexcept = default;
+public:
+    /**
+     * @brief An output iterator that appends to a String, usable with std::format_to and std::ranges::copy
+     * @note The appended bytes must form valid UTF-8 once writing is done
+     */
+    struct BackInsertIterator
+    {
+        using iterator_category = std::output_iterator_tag;
+        using value_type = void;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = void;
 
-            explicit SplitASCIIWhiteSpaceIter(const str* s) noexcept : s(s)
-            {
-                if (s != nullptr)
-                {
-                    utf8proc_int32_t codepoint = 0;
-                    const auto size = this->s->size();
+        String* string = nullptr;
 
-                    // Skip leading whitespace
-                    while (this->pos < size)
-                    {
-                        const auto advance = utf8proc_iterate(
-                            reinterpret_cast<const utf8proc_uint8_t*>(this->s->m_data + this->pos),
-                            size - this->pos,
-                            &codepoint
-                        );
+        constexpr BackInsertIterator() noexcept = default;
 
-                        if (!std::bit_cast<Char>(codepoint).is_ascii_whitespace())
-                        {
-                            break;
-                        }
+        constexpr explicit BackInsertIterator(String& string) noexcept : string(&string) {}
 
-                        this->pos += advance;
-                    }
+        auto operator=(char ch) -> BackInsertIterator&
+        {
+            this->string->reserve_for_append(1);
+            this->string->m_data[this->string->m_len] = static_cast<std::byte>(ch);
+            this->string->finish_append(1);
 
-                    // If we've reached the end or string is all whitespace, set to end iterator
-                    if (this->pos >= size)
-                    {
-                        this->s = nullptr;
-                        return;
-                    }
+            return *this;
+        }
 
-                    // Find the end of the current non-whitespace sequence
-                    const auto start_pos = this->pos;
-                    while (this->pos < size)
-                    {
-                        const auto advance = utf8proc_iterate(
-                            reinterpret_cast<const utf8proc_uint8_t*>(this->s->m_data + this->pos),
-                            size - this->pos,
-                            &codepoint
-                        );
+        [[nodiscard]] constexpr auto operator*() noexcept -> BackInsertIterator&
+        {
+            return *this;
+        }
 
-                        if (std::bit_cast<Char>(codepoint).is_ascii_whitespace())
-                        {
-                            break;
-                        }
+        constexpr auto operator++() noexcept -> BackInsertIterator&
+        {
+            return *this;
+        }
 
-                        this->pos += advance;
-                    }
+        constexpr auto operator++(int) noexcept -> BackInsertIterator
+        {
+            return *this;
+        }
 
-                    this->span = plain_str(this->s->m_data + start_pos, this->pos - start_pos);
-                }
-            }
+        /**
+         * @brief Reserves room for at least additional bytes ahead of the writes, growing the capacity geometrically
+         */
+        auto reserve(size_t additional) -> void
+        {
+            this->string->reserve_for_append(additional);
+        }
 
-            auto operator++() noexcept -> SplitASCIIWhiteSpaceIter&
-            {
-                if (this->s == nullptr)
-                {
-                    return *this;
-                }
+        /**
+         * @brief Appends the bytes in a single copy
+         */
+        auto append(std::string_view bytes) -> void
+        {
+            this->string->reserve_for_append(bytes.size());
+            std::copy(bytes.begin(), bytes.end(), std::bit_cast<char*>(this->string->m_data + this->string->m_len));
+            this->string->finish_append(bytes.size());
+        }
 
-                utf8proc_int32_t codepoint = 0;
-                const auto size = this->s->size();
+        /**
+         * @brief Returns the allocated but unused bytes after the end of the string, to be written directly
+         */
+        [[nodiscard]] auto spare_capacity() const noexcept -> std::span<char>
+        {
+            return std::span(
+                std::bit_cast<char*>(this->string->m_data + this->string->m_len),
+                this->string->m_alloc_and_capacity.second - this->string->m_len
+            );
+        }
 
-                // Skip whitespace
-                while (this->pos < size)
-                {
-                    const auto advance = utf8proc_iterate(
-                        reinterpret_cast<const utf8proc_uint8_t*>(this->s->m_data + this->pos),
-                        size - this->pos,
-                        &codepoint
-                    );
+        /**
+         * @brief Makes the first len bytes written into spare_capacity() part of the string
+         */
+        auto commit(size_t len) noexcept -> void
+        {
+            this->string->finish_append(len);
+        }
+    };
 
-                    if (!std::bit_cast<Char>(codepoint).is_ascii_whitespace())
-                    {
-                        break;
-                    }
+// constructors
+public:
+    constexpr explicit String(const Alloc& alloc = Alloc()) noexcept : m_data(nullptr), m_len(0), m_alloc_and_capacity(alloc, 0) {}
 
-                    this->pos += advance;
-                }
+    constexpr String(const str& str, const Alloc& alloc = Alloc()) : String(alloc)
+    {
+        (*this) += str;
+    }
 
-                // If we've reached the end, set to end iterator
-                if (this->pos >= size)
-                {
-                    this->s = nullptr;
-                    return *this;
-                }
+    constexpr String(const plain_str& str, const Alloc& alloc = Alloc()) : String(alloc)
+    {
+        (*this) += crab_cpp::str(str);
+    }
 
-                // Find the end of the current non-whitespace sequence
-                const auto start_pos = this->pos;
-                while (this->pos < size)
-                {
-                    const auto advance = utf8proc_iterate(
-                        reinterpret_cast<const utf8proc_uint8_t*>(this->s->m_data + this->pos),
-                        size - this->pos,
-                        &codepoint
-                    );
+    /**
+     * @brief Creates a string from a view of bytes, or from a sized range of bytes such as a std::vector or a std::deque.
+     * Contiguous sized ranges are copied with a single memcpy and other sized ranges reserve their size up front.
+     * @param bytes The bytes to copy
+     * @param alloc The allocator to use
+     * @note Panics if the bytes are not a valid UTF-8 sequence
+     */
+    template<ByteRange R>
+    constexpr String(R&& bytes, const Alloc& alloc = Alloc()) : String(alloc)
+    {
+        this->append_bytes(bytes);
 
-                    if (std::bit_cast<Char>(codepoint).is_ascii_whitespace())
-                    {
-                        break;
-                    }
+        if (!is_valid_utf8(this->m_data, this->m_len))
+        {
+            panic("Invalid UTF-8 sequence encountered while calling String constructor");
+        }
+    }
 
-                    this->pos += advance;
-                }
+    /**
+     * @brief Creates a string from a UTF-8 string
+     * @param str The input string
+     * @param len The length of the input string
+     * @param alloc The allocator to use
+     * @return A Result containing either a String or a FromUtf8Error
+     */
+    [[nodiscard]] static auto from_raw_parts(const char* str, size_t len, const Alloc& alloc = Alloc()) -> Result<String, FromUtf8Error>
+    {
+        auto alloc_copy = alloc;
 
-                this->span = plain_str(this->s->m_data + start_pos, this->pos - start_pos);
+        if (str == nullptr || len == 0)
+        {
+            return String(alloc_copy, nullptr, 0, 0);
+        }
 
-                return *this;
-            }
+        auto result = str::from_raw_parts(str, len);
+        if (result.is_err())
+        {
+            return result.unwrap_err();
+        }
 
-            [[nodiscard]] auto operator++(int) noexcept -> SplitASCIIWhiteSpaceIter
-            {
-                SplitASCIIWhiteSpaceIter temp = *this;
-                ++(*this);
-                return temp;
-            }
+        const auto [data, capacity] = String::allocate_buffer(alloc_copy, len);
+        std::copy(str, str + len, std::bit_cast<char*>(data));
+        data[len] = std::byte{0};
 
-            [[nodiscard]] constexpr auto operator==(const SplitASCIIWhiteSpaceIter& other) const noexcept -> bool
-            {
-                return this->s == other.s;
-            }
+        return String(alloc_copy, data, len, capacity);
+    }
 
-            [[nodiscard]] constexpr auto operator*() const noexcept -> reference
-            {
-                return this->span;
-            }
+    /**
+     * @brief Creates a string from a null-terminated, UTF-8 encoded C style string
+     * @param str The input string
+     * @param alloc The allocator to use
+     * @return A Result containing either a String or a FromUtf8Error
+     */
+    [[nodiscard]] static auto from(const char* str, const Alloc& alloc = Alloc()) -> Result<String, FromUtf8Error>
+    {
+        return String::from_raw_parts(str, std::strlen(str), alloc);
+    }
 
-            [[nodiscard]] constexpr auto operator->() const noexcept -> pointer
-            {
-                return &this->span;
-            }
-        };
+    /**
+     * @brief Creates a string from UTF-16 code units
+     * @param units The input code units
+     * @param alloc The allocator to use
+     * @return A Result containing either a String or a FromUtf16Error if the input contains an unpaired surrogate
+     */
+    [[nodiscard]] static auto from_utf16(std::u16string_view units, const Alloc& alloc = Alloc()) -> Result<String, FromUtf16Error>
+    {
+        const auto [len, invalid] = transcode::utf8_len_of_utf16(units);
+        if (invalid != units.size())
+        {
+            return FromUtf16Error(invalid);
+        }
 
-    public:
-        constexpr explicit SplitASCIIWhiteSpace(const str& s) : s(&s) {}
+        return String::from_transcoded(len, alloc, [units](std::byte* out) { transcode::utf16_to_utf8(units, out); });
+    }
 
-    public:
-        [[nodiscard]] auto begin() const noexcept -> SplitASCIIWhiteSpaceIter
+    /**
+     * @brief Creates a string from UTF-16 code units, replacing each unpaired surrogate with U+FFFD
+     * @param units The input code units
+     * @param alloc The allocator to use
+     * @return The String holding the converted text
+     */
+    [[nodiscard]] static auto from_utf16_lossy(std::u16string_view units, const Alloc& alloc = Alloc()) -> String
+    {
+        const size_t len = transcode::utf8_len_of_utf16(units).first;
+        return String::from_transcoded(len, alloc, [units](std::byte* out) { transcode::utf16_to_utf8(units, out); });
+    }
+
+    /**
+     * @brief Creates a string from UTF-32 code points
+     * @param cps The input code points
+     * @param alloc The allocator to use
+     * @return A Result containing either a String or a FromUtf32Error if the input contains a value that is not a
+     *         Unicode scalar value
+     */
+    [[nodiscard]] static auto from_utf32(std::u32string_view cps, const Alloc& alloc = Alloc()) -> Result<String, FromUtf32Error>
+    {
+        const auto [len, invalid] = transcode::utf8_len_of_utf32(cps);
+        if (invalid != cps.size())
         {
-            return SplitASCIIWhiteSpaceIter(this->s);
+            return FromUtf32Error(invalid);
         }
 
-        [[nodiscard]] auto end() const noexcept -> SplitASCIIWhiteSpaceIter
-        {
-            return SplitASCIIWhiteSpaceIter(nullptr);
-        }
+        return String::from_transcoded(len, alloc, [cps](std::byte* out) { transcode::utf32_to_utf8(cps, out); });
+    }
 
-        using iterator = SplitASCIIWhiteSpaceIter;
-        using const_iterator = SplitASCIIWhiteSpaceIter;
-    };
+    /**
+     * @brief Creates a string from Latin-1 (ISO-8859-1) text, every byte is the code point of one char
+     * @param bytes The input bytes
+     * @param alloc The allocator to use
+     * @return The String holding the converted text
+     */
+    [[nodiscard]] static auto from_latin1(std::string_view bytes, const Alloc& alloc = Alloc()) -> String
+    {
+        const size_t len = transcode::utf8_len_of_latin1(bytes);
+        return String::from_transcoded(len, alloc, [bytes](std::byte* out) { transcode::latin1_to_utf8(bytes, out); });
+    }
 
-    struct Chars
+    /**
+     * @brief Creates a string from bytes that may contain invalid UTF-8, replacing each invalid sequence with U+FFFD
+     * @details An invalid sequence is the longest prefix of a valid sequence, or a single byte if no valid sequence
+     *          starts with it, the same as the maximal subparts of the Unicode standard.
+     * @param bytes The input bytes
+     * @param alloc The allocator to use
+     * @return The bytes borrowed as a str if they are valid UTF-8, otherwise a String holding the repaired text
+     */
+    [[nodiscard]] static auto from_utf8_lossy(std::span<const std::byte> bytes, const Alloc& alloc = Alloc()) -> Cow<Alloc>
     {
-        const str* s = nullptr;
+        constexpr auto replacement = std::array{std::byte{0xEF}, std::byte{0xBF}, std::byte{0xBD}};
 
-        struct CharsIter
-        {
-            using iterator_category = std::forward_iterator_tag;
-            using difference_type = std::ptrdiff_t;
-            using value_type = Char;
-            using pointer = const Char*;
-            using reference = const Char&;
+        auto validator = Utf8Validator();
+        validator.feed(bytes);
 
-            const str* s = nullptr;
-            size_t pos = 0;
-            Char ch;
+        if (validator.is_complete())
+        {
+            return str::from_bytes_unchecked(bytes.data(), bytes.size());
+        }
 
-            constexpr explicit CharsIter() noexcept = default;
+        // A replacement takes at most 2 more bytes than the sequence it replaces, this covers the first one
+        auto string = String(alloc);
+        string.reserve(bytes.size() + 2);
+        size_t pos = 0;
 
-            explicit CharsIter(const str* s, size_t pos) noexcept : s(s), pos(pos)
+        while (true)
+        {
+            string.append_bytes(bytes.subspan(pos, validator.valid_up_to()));
+            if (validator.is_complete())
             {
-                this->pos += utf8proc_iterate(
-                    reinterpret_cast<const utf8proc_uint8_t*>(this->s->data() + this->pos),
-                    this->s->size() - this->pos,
-                    reinterpret_cast<utf8proc_int32_t*>(&this->ch)
-                );
+                break;
             }
 
-            constexpr auto operator++() noexcept -> CharsIter&
-            {
-                if (this->s == nullptr || this->pos >= this->s->size())
-                {
-                    return *this;
-                }
+            // After a rejected byte the pending bytes are the invalid sequence, the rejected byte is only part of it
+            // if it could not start a sequence
+            string.append_bytes(replacement);
+            pos += validator.valid_up_to() + std::max<size_t>(validator.pending_len(), 1);
 
-                this->pos += utf8proc_iterate(
-                    reinterpret_cast<const utf8proc_uint8_t*>(this->s->data() + this->pos),
-                    this->s->size() - this->pos,
-                    reinterpret_cast<utf8proc_int32_t*>(&this->ch)
-                );
+            validator.reset();
+            validator.feed(bytes.subspan(pos));
+        }
 
-                return *this;
-            }
+        return string;
+    }
 
-            constexpr auto operator->() const noexcept -> pointer
-            {
-                return std::bit_cast<const Char*>(&this->ch);
-            }
+    /**
+     * @brief Creates a string from bytes that may contain invalid UTF-8, replacing each invalid sequence with U+FFFD
+     * @param str The input bytes
+     * @param len The length of the input in bytes
+     * @param alloc The allocator to use
+     * @return The bytes borrowed as a str if they are valid UTF-8, otherwise a String holding the repaired text
+     */
+    [[nodiscard]] static auto from_utf8_lossy(const char* str, size_t len, const Alloc& alloc = Alloc()) -> Cow<Alloc>
+    {
+        return String::from_utf8_lossy(std::span(std::bit_cast<const std::byte*>(str), len), alloc);
+    }
 
-            constexpr auto operator*() const noexcept -> reference
-            {
-                return this->ch;
-            }
+    /**
+     * @brief Creates a string from a range of bytes that are already known to be valid UTF-8, skipping the validation
+     * @param bytes The bytes to copy, a view or a sized range
+     * @param alloc The allocator to use
+     * @return The String holding a copy of the bytes
+     * @warning The bytes must form a valid UTF-8 sequence
+     */
+    template<ByteRange R>
+    [[nodiscard]] static auto from_bytes_unchecked(R&& bytes, const Alloc& alloc = Alloc()) -> String
+    {
+        auto string = String(alloc);
+        string.append_bytes(bytes);
 
-            [[nodiscard]] constexpr auto operator==(const CharsIter& other) const noexcept -> bool
-            {
-                return this->s->m_data == other.s->m_data && this->pos == other.pos;
-            }
-        };
+        return string;
+    }
 
-        constexpr explicit Chars(const str& s) noexcept : s(&s) {}
+    String(const String& other)
+        : m_data(nullptr)
+        , m_len(0), m_alloc_and_capacity(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.m_alloc_and_capacity.first()), 0)
+    {
+        (*this) += other;
+    }
 
-        auto begin() const noexcept -> CharsIter
-        {
-            return CharsIter(this->s, 0);
-        }
+    String(String&& other) noexcept
+        : m_data(other.m_data), m_len(other.m_len), m_alloc_and_capacity(std::move(other.m_alloc_and_capacity))
+    {
+        other.m_data = nullptr;
+        other.m_len = 0;
+        other.m_alloc_and_capacity.second = 0;
+    }
 
-        auto end() const noexcept -> CharsIter
+    ~String()
+    {
+        if (this->m_data != nullptr)
         {
-            return CharsIter(this->s, this->s->size());
+            String::deallocate_buffer(this->m_alloc_and_capacity.first(), this->m_data, this->m_alloc_and_capacity.second);
         }
+    }
 
-        using iterator = CharsIter;
-        using const_iterator = CharsIter;
-    };
-
-    struct Graphemes
+// functions
+public:
+    /**
+     * @brief Returns a byte slice of this String's contents
+     * @return A span containing the string's bytes
+     */
+    [[nodiscard]] constexpr auto as_bytes() const noexcept -> std::span<const std::byte>
     {
-        const str* s = nullptr;
-
-        struct GraphemesIter
-        {
-            using iterator_category = std::forward_iterator_tag;
-            using difference_type = std::ptrdiff_t;
-            using value_type = plain_str;
-            using pointer = const plain_str*;
-            using reference = const plain_str&;
+        return std::span(
+            reinterpret_cast<const std::byte*>(this->m_data),
+        this->m_len
+        );
+    }
 
-            const str* s = nullptr;
-            size_t pos = 0;
-            utf8proc_int32_t state = 0;
-            plain_str current;
+    /**
+     * @brief Returns a byte slice of this String's contents
+     * @return A span containing the string's bytes
+     */
+    [[nodiscard]] constexpr auto as_raw() const noexcept -> const char*
+    {
+        return reinterpret_cast<const char*>(this->m_data);
+    }
 
-            constexpr explicit GraphemesIter() noexcept = default;
+    /**
+     * @brief Returns a byte slice of this String's contents
+     * @return A span containing the string's bytes
+     */
+    [[nodiscard]] constexpr auto as_str() const noexcept -> const str&
+    {
+        return *(reinterpret_cast<const str*>(this));
+    }
 
-            constexpr explicit GraphemesIter(const str* s, size_t pos) noexcept : s(s), pos(pos)
-            {
-                if (s != nullptr)
-                {
-                    this->advance();
-                }
-            }
+    /**
+     * @brief Returns an output iterator that appends to this String
+     */
+    [[nodiscard]] auto back_inserter() noexcept -> BackInsertIterator
+    {
+        return BackInsertIterator(*this);
+    }
 
-            constexpr auto advance() noexcept -> void
-            {
-                if (this->s == nullptr || this->pos >= this->s->size())
-                {
-                    return;
-                }
+    /**
+     * @brief Returns a C-style string of this String's contents
+     * @return A C-style string of this String's contents
+     */
+    [[nodiscard]] constexpr auto c_str() const noexcept -> const char*
+    {
+        return std::bit_cast<const char*>(this->m_data);
+    }
 
-                utf8proc_int32_t codepoint1 = 0;
-                utf8proc_int32_t codepoint2 = 0;
-                size_t start_pos = this->pos;
+    /**
+     * @brief Returns the current capacity of the buffer in bytes
+     * @return The capacity in bytes
+     */
+    [[nodiscard]] constexpr auto capacity() const noexcept -> size_t
+    {
+        return this->m_alloc_and_capacity.second;
+    }
 
-                // Get the first codepoint
-                auto advance = utf8proc_iterate(
-                    reinterpret_cast<const utf8proc_uint8_t*>(this->s->data() + this->pos),
-                    this->s->size() - this->pos,
-                    &codepoint1
-                );
-                this->pos += advance;
+    /**
+     * @brief Clears the string content but keeps the allocated memory
+     */
+    constexpr auto clear() noexcept -> void
+    {
+        this->m_len = 0;
+    }
 
-                // Keep advancing until we find a grapheme break
-                while (this->pos < this->s->size())
-                {
-                    advance = utf8proc_iterate(
-                        reinterpret_cast<const utf8proc_uint8_t*>(this->s->data() + this->pos),
-                        this->s->size() - this->pos,
-                        &codepoint2
-                    );
+    /**
+     * @brief Returns a pointer to the string data
+     */
+    [[nodiscard]] constexpr auto data() const noexcept -> const std::byte*
+    {
+        return this->m_data;
+    }
 
-                    if (utf8proc_grapheme_break_stateful(codepoint1, codepoint2, &this->state))
-                    {
-                        break;
-                    }
+    /**
+     * @brief Returns a pointer to the string data
+     */
+    [[nodiscard]] constexpr auto data() noexcept -> std::byte*
+    {
+        return this->m_data;
+    }
 
-                    codepoint1 = codepoint2;
-                    this->pos += advance;
-                }
+    [[nodiscard]] constexpr auto empty() const noexcept -> bool
+    {
+        return this->m_len == 0;
+    }
 
-                this->current = plain_str(this->s->data() + start_pos, this->pos - start_pos);
+    /**
+     * @brief Converts this string to its ASCII lower case equivalent in-place.
+     * ASCII letters 'A' to 'Z' are mapped to 'a' to 'z', but non-ASCII letters are unchanged.
+     */
+    auto make_ascii_lowercase() noexcept -> void
+    {
+        for (size_t i = 0; i < this->m_len; i += 1)
+        {
+            const auto ch = static_cast<std::uint8_t>(this->m_data[i]);
+            if (ch >= 65 && ch <= 90)
+            {
+                this->m_data[i] = static_cast<std::byte>(ch | 0x20);
             }
+        }
+    }
 
-            constexpr auto operator++() noexcept -> GraphemesIter&
+    /**
+     * @brief Converts this string to its ASCII lower case equivalent in-place.
+     * ASCII letters 'a' to 'z' are mapped to 'A' to 'Z', but non-ASCII letters are unchanged.
+     */
+    auto make_ascii_uppercase() noexcept -> void
+    {
+        for (size_t i = 0; i < this->m_len; i += 1)
+        {
+            const auto ch = static_cast<std::uint8_t>(this->m_data[i]);
+            if (ch >= 97 && ch <= 122)
             {
-                this->advance();
-                return *this;
+                this->m_data[i] = static_cast<std::byte>(ch & 0xDF);
             }
+        }
+    }
+
+    /**
+     * @brief Returns the current length of the string in bytes
+     * @return The length in bytes
+     */
+    [[nodiscard]] constexpr auto size() const noexcept -> size_t
+    {
+        return this->m_len;
+    }
+
+    /**
+     * @brief Reserves capacity for at least additional bytes more than the current length.
+     * The capacity grows to at least twice its current value, so a sequence of reserves and appends copies each byte
+     * a constant number of times on average. A string that has not allocated yet gets exactly what it asks for, with
+     * a minimum of 16 bytes.
+     * After calling reserve, capacity will be greater than or equal to this->size() + additional.
+     * Does nothing if capacity is already sufficient.
+     * @param additional The number of additional bytes to reserve
+     * @note Panics if the new capacity overflows size_t
+     */
+    auto reserve(size_t additional) -> void
+    {
+        const size_t old_capacity = this->m_alloc_and_capacity.second;
+        const size_t required = this->size() + additional;
+
+        if (required < this->size())
+        {
+            panic("New capacity overflows in String::reserve");
+        }
+
+        if (required <= old_capacity)
+        {
+            return;
+        }
 
-            constexpr auto operator++(int) noexcept -> GraphemesIter
-            {
-                GraphemesIter temp = *this;
-                ++(*this);
-                return temp;
-            }
+        // Past half the address space doubling would overflow, required alone is used then
+        const size_t doubled = old_capacity <= std::numeric_limits<size_t>::max() / 2 ? old_capacity * 2 : required;
+        const size_t new_capacity = std::max({required, doubled, size_t(16)});
 
-            [[nodiscard]] constexpr auto operator==(const GraphemesIter& other) const noexcept -> bool
+        if constexpr (uses_malloc)
+        {
+            // realloc grows the block in place when it can and copies only when it must
+            const auto new_data = static_cast<pointer>(std::realloc(this->m_data, new_capacity + 1));
+            if (new_data == nullptr)
             {
-                return this->s == other.s && this->pos == other.pos;
+                throw std::bad_alloc();
             }
 
-            [[nodiscard]] constexpr auto operator*() const noexcept -> reference
+            new_data[this->m_len] = std::byte{0};
+            this->m_data = new_data;
+            this->m_alloc_and_capacity.second = new_capacity;
+        }
+        else
+        {
+            const auto [new_data, capacity] = String::allocate_buffer(this->m_alloc_and_capacity.first(), new_capacity);
+
+            // Copy existing data
+            if (this->m_len > 0)
             {
-                return this->current;
+                std::copy(this->m_data, this->m_data + this->m_len, new_data);
             }
+            // Add null terminator
+            new_data[this->m_len] = std::byte{0};
 
-            [[nodiscard]] constexpr auto operator->() const noexcept -> pointer
+            // Deallocate old memory
+            if (this->m_data != nullptr)
             {
-                return &this->current;
+                String::deallocate_buffer(this->m_alloc_and_capacity.first(), this->m_data, this->m_alloc_and_capacity.second);
             }
-        };
-
-        constexpr explicit Graphemes(const str& s) noexcept : s(&s) {}
-
-        [[nodiscard]] constexpr auto begin() const noexcept -> GraphemesIter
-        {
-            return GraphemesIter(this->s, 0);
-        }
 
-        [[nodiscard]] constexpr auto end() const noexcept -> GraphemesIter
-        {
-            return GraphemesIter(this->s, this->s->size());
+            this->m_data = new_data;
+            this->m_alloc_and_capacity.second = capacity;
         }
+    }
 
-        using iterator = GraphemesIter;
-        using const_iterator = GraphemesIter;
-    };
-
-public:
-    [[nodiscard]] constexpr auto chars() const noexcept -> Chars
+    /**
+     * @brief Appends the given Char to the end of this String.
+     * @param ch The Char to append
+     */
+    auto push(Char ch) -> void
     {
-        return Chars(*this);
+        (*this) += ch;
     }
 
     /**
-     * @brief Returns an iterator over the lines of this string
-     * @return A Lines iterator that yields each line in the string
+     * @brief Appends a given str onto the end of this String.
+     * @param str The str to append
      */
-    [[nodiscard]] constexpr auto lines() const noexcept -> Lines
+    auto push_str(const str& str) -> void
     {
-        return Lines(*this);
+        (*this) += str;
     }
 
     /**
-     * @brief Returns an iterator that yields index of each match of the pattern in the str
-     * @param pattern The pattern to match against
-     * @return A Matches iterator that yields each match in the string
+     * @brief Appends the decimal representation of an integer, formatted directly into the buffer
+     * @param value The integer to append
      */
-    [[nodiscard]] constexpr auto matches(const str& pattern) const noexcept -> Matches
+    template<typename T>
+        requires std::integral<T> && (!std::same_as<T, bool>)
+    auto push_int(T value) -> void
     {
-        return Matches(*this, plain_str(pattern.m_data, pattern.m_len));
+        // One more for the sign, one more because digits10 rounds down
+        constexpr size_t max_len = std::numeric_limits<T>::digits10 + 2;
+        this->reserve_for_append(max_len);
+
+        const auto first = std::bit_cast<char*>(this->m_data + this->m_len);
+        const auto result = std::to_chars(first, first + max_len, value);
+        this->finish_append(size_t(result.ptr - first));
     }
 
-    template<typename Alloc>
-    [[nodiscard]] constexpr auto matches(const raw::String<Alloc>& pattern) const noexcept -> Matches
+    /**
+     * @brief Appends the shortest decimal representation of a floating point value that round-trips,
+     * formatted directly into the buffer
+     * @param value The floating point value to append
+     */
+    template<typename T>
+        requires std::floating_point<T>
+    auto push_float(T value) -> void
     {
-        return Matches(*this, plain_str(pattern.m_data, pattern.m_len));
+        // The scientific form is the longest one to_chars picks: sign, digits, point, 'e', exponent sign and digits
+        constexpr size_t max_len = std::numeric_limits<T>::max_digits10 + 8;
+        this->reserve_for_append(max_len);
+
+        const auto first = std::bit_cast<char*>(this->m_data + this->m_len);
+        const auto result = std::to_chars(first, first + max_len, value);
+        this->finish_append(size_t(result.ptr - first));
     }
 
-    [[nodiscard]] auto matches(const char* pattern) const noexcept -> Matches
+    /**
+     * @brief Appends the hexadecimal representation of an integer without prefix.
+     * Negative values are written as their two's complement, like Rust's {:x}.
+     * @param value The integer to append
+     * @param uppercase Whether to use uppercase letters
+     */
+    template<typename T>
+        requires std::integral<T> && (!std::same_as<T, bool>)
+    auto push_hex(T value, bool uppercase = false) -> void
     {
-        const auto s = str::from(pattern).ok().expect_take("Invalid UTF-8 sequence while calling str::split#pattern");
-        return Matches(*this, plain_str(s.data(), s.size()));
+        const auto bits = static_cast<std::make_unsigned_t<T>>(value);
+        const size_t len = std::max<size_t>((std::bit_width(bits) + 3) / 4, 1);
+        this->reserve_for_append(len);
+
+        const char* digits = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+        auto remaining = bits;
+
+        for (size_t i = len; i > 0; i -= 1)
+        {
+            this->m_data[this->m_len + i - 1] = static_cast<std::byte>(digits[remaining & 0xF]);
+            remaining >>= 4;
+        }
+
+        this->finish_append(len);
     }
 
     /**
-     * @brief Returns an iterator that splits the string by the given pattern
-     * @param pattern The pattern to split on
-     * @return A Split iterator that yields each part of the split string
+     * @brief Splits the string into two at the given byte index
+     * @param at The byte index at which to split
+     * @return A newly allocated String containing bytes [at, len)
+     * @note Panics If at is not on a UTF-8 code point boundary, or if it is beyond the last code point
      */
-    [[nodiscard]] constexpr auto split(const str& pattern) const noexcept -> Split
+    auto split_off(size_t at) -> String
     {
-        return Split(*this, plain_str(pattern.m_data, pattern.m_len));
+        if (at >= this->m_len)
+        {
+            panic("Split index out of bounds");
+        }
+
+        // Verify that 'at' is on a UTF-8 code point boundary
+        if (!this->as_str().is_char_boundary(at))
+        {
+            panic("Split index not on UTF-8 code point boundary");
+        }
+
+        // Create new string with the second part
+        String result(this->m_alloc_and_capacity.first(), nullptr, 0, 0);
+        result.reserve(this->m_len - at);
+
+        // Copy the bytes [at, len) to the new string
+        std::copy(this->m_data + at,
+                 this->m_data + this->m_len,
+                 result.m_data);
+        result.m_len = this->m_len - at;
+        // Add null terminator to the new string
+        result.m_data[result.m_len] = std::byte{0};
+
+        // Update this string's length and add null terminator
+        this->m_len = at;
+        this->m_data[this->m_len] = std::byte{0};
+
+        return result;
     }
 
     /**
-     * @brief Returns an iterator that splits the string by the given pattern
-     * @param pattern The pattern to split on
-     * @return A Split iterator that yields each part of the split string
+     * @brief Shortens this String to the specified length.
+     * @details If new_len is greater than or equal to the string's current length, this has no effect.
+     *          Note that this method has no effect on the allocated capacity of the string
+     * @param new_len The new length of the string
+     * @note Panics if new_len does not lie on a char boundary.
      */
-    template<typename Alloc>
-    [[nodiscard]] constexpr auto split(const raw::String<Alloc>& pattern) const noexcept -> Split
+    auto truncate(size_t new_len) noexcept -> void
     {
-        return Split(*this, plain_str(pattern.m_data, pattern.m_len));
+        if (new_len >= this->m_len)
+        {
+            return;
+        }
+
+        if (!this->as_str().is_char_boundary(new_len))
+        {
+            panic("Invalid UTF-8 sequence while calling String::truncate");
+        }
+
+        this->m_len = new_len;
+        this->m_data[this->m_len] = std::byte{0};
     }
 
     /**
-     * @brief Returns an iterator that splits the string by the given pattern
-     * @param pattern The pattern to split on
-     * @return A Split iterator that yields each part of the split string
-     * @note Panics If the pattern is not a valid UTF-8 sequence
+     * @brief Removes the last character from the string buffer and returns it
+     * @return Option containing the removed character, or None if the string is empty
      */
-    [[nodiscard]] auto split(const char* pattern) const noexcept -> Split
+    [[nodiscard]] auto pop() noexcept -> Option<Char>
     {
-        const auto s = str::from(pattern).ok().expect_take("Invalid UTF-8 sequence while calling str::split#pattern");
-        return Split(*this, plain_str(s.m_data, s.m_len));
+        if (this->m_len == 0)
+        {
+            return None{};
+        }
+
+        // Find the start of the last UTF-8 sequence by scanning backwards
+        size_t start = this->m_len - 1;
+        while (start > 0 && (this->m_data[start] & std::byte{0xC0}) == std::byte{0x80})
+        {
+            start -= 1;
+        }
+
+        // Decode the UTF-8 sequence
+        utf8proc_int32_t codepoint = 0;
+        utf8proc_iterate(
+            reinterpret_cast<const utf8proc_uint8_t*>(this->m_data + start),
+            this->m_len - start,
+            &codepoint
+        );
+
+        // Update string length
+        this->m_len = start;
+        // Add null terminator at new end
+        this->m_data[this->m_len] = std::byte{0};
+
+        return Char(static_cast<std::uint32_t>(codepoint));
+    }
+
+//operators
+public:
+    [[nodiscard]] auto operator->() noexcept -> str*
+    {
+        return std::bit_cast<str*>(this);
+    }
+
+    [[nodiscard]] auto operator->() const noexcept -> const str*
+    {
+        return std::bit_cast<const str*>(this);
+    }
+
+    auto operator=(const String& other) -> String&
+    {
+        this->clear();
+        (*this) += other;
+
+        return *this;
     }
 
     /**
-     * @brief Returns an iterator that splits the string by ASCII whitespaces
-     * @return A SplitASCIIWhiteSpace iterator that yields each part of the split string
+     * @brief Appends the given Char to the end of this String.
+     * @param ch The Char to append
+     * @return A reference to this String
      */
-    [[nodiscard]] constexpr auto split_ascii_whitespace() const noexcept -> SplitASCIIWhiteSpace
+    auto operator+=(const Char ch) -> String&
     {
-       return SplitASCIIWhiteSpace(*this);
+        // Convert Unicode scalar value to UTF-8
+        utf8proc_uint8_t utf8[4];
+        const auto len = utf8proc_encode_char(
+            static_cast<utf8proc_int32_t>(ch.code_point()),
+            utf8
+        );
+
+        if (len < 0)
+        {
+            panic("Failed to encode Unicode scalar value to UTF-8");
+        }
+
+        const size_t new_len = this->m_len + static_cast<size_t>(len);
+        this->reserve_for_append(static_cast<size_t>(len));
+
+        std::copy(utf8, utf8 + len, reinterpret_cast<utf8proc_uint8_t*>(this->m_data + this->m_len));
+        this->m_len = new_len;
+        // Add null terminator
+        this->m_data[this->m_len] = std::byte{0};
+
+        return *this;
     }
 
     /**
-     * @brief Returns an iterator that yields each grapheme in the string
-     * @return A Graphemes iterator that yields each grapheme in the string
+     * @brief Appends a str to this String using the += operator
+     * @param str The str to append
+     * @return A reference to this String
      */
-    [[nodiscard]] constexpr auto graphemes() const noexcept -> Graphemes
+    auto operator+=(const String& str) -> String&
     {
-        return Graphemes(*this);
+        return (*this) += str.as_str();
     }
 
-// operators
-public:
-    [[nodiscard]] constexpr auto operator<=>(const str& other) const noexcept -> std::strong_ordering
+    /**
+     * @brief Appends a str to this String using the += operator
+     * @param str The str to append
+     * @return A reference to this String
+     */
+    auto operator+=(const str& str) -> String&
     {
-        // If both strings are empty, they are equal
-        if (this->m_len == 0 && other.m_len == 0)
+        if (str.empty())
         {
-            return std::strong_ordering::equal;
+            return *this;
         }
 
-        // If this string is empty, it's less than any non-empty string
-        if (this->m_len == 0)
-        {
-            return std::strong_ordering::less;
-        }
+        const size_t new_len = this->m_len + str.size();
+        this->reserve_for_append(str.size());
 
-        // If other string is empty, this string is greater
-        if (other.m_len == 0)
-        {
-            return std::strong_ordering::greater;
-        }
+        std::copy(str.data(), str.data() + str.size(), this->m_data + this->m_len);
+        this->m_len = new_len;
+        // Add null terminator
+        this->m_data[this->m_len] = std::byte{0};
 
-        // Compare byte by byte until we find a difference
-        const size_t min_len = std::min(this->m_len, other.m_len);
-        for (size_t i = 0; i < min_len; ++i)
-        {
-            if (this->m_data[i] != other.m_data[i])
-            {
-                return this->m_data[i] <=> other.m_data[i];
-            }
-        }
+        return *this;
+    }
 
-        // If we get here, one string is a prefix of the other
-        // The shorter string is considered less
-        return this->m_len <=> other.m_len;
+    /**
+     * @brief Appends a C-string to this String using the += operator
+     * @param str The C-string to append
+     * @return A reference to this String
+     */
+    auto operator+=(const char* str) -> String&
+    {
+        return (*this) += str::from(str).expect("Invalid UTF-8 sequence while calling String::operator+=");
     }
 
-    [[nodiscard]] constexpr auto operator==(const str& other) const noexcept -> bool
+    auto operator+(const String& str) -> String
     {
-        if (this->m_len != other.m_len)
-        {
-            return false;
-        }
-        return std::equal(this->m_data, this->m_data + this->m_len, other.m_data);
+        return (*this) + str.as_str();
     }
-};
 
-namespace strings
-{
-    constexpr auto join_with(char ch) -> decltype(auto)
+    auto operator+(const str& str) -> String
     {
-        return std::views::join_with(static_cast<std::byte>(ch));
+        auto string = String();
+        string.reserve(this->m_len + str.size());
+        string += *this;
+        string += str;
+
+        return string;
     }
 
-    auto join_with(const char* str) -> decltype(auto)
+    auto operator+(const Char ch) -> String
     {
-        const auto s = str::from(str).expect("Invalid UTF-8 sequence while calling strings::join_with#str");
-        return std::views::join_with(s.as_bytes());
+        auto string = String();
+        string.reserve(this->m_len + sizeof(Char));
+        string += *this;
+        string += ch;
+
+        return string;
     }
 
-    constexpr auto join_with(const str& str) -> decltype(auto)
+    auto operator+(const char* str) -> String
     {
-        return std::views::join_with(str.as_bytes());
+        return (*this) + str::from(str).expect("Invalid UTF-8 sequence while calling String::operator+=");
     }
 
-    template<typename Alloc = std::allocator<std::byte>>
-    constexpr auto join_with(const raw::String<Alloc>& str) -> decltype(auto)
+    [[nodiscard]] constexpr auto operator<=>(const String& other) const noexcept -> std::strong_ordering
     {
-        return std::views::join_with(str.as_bytes());
+        return this->as_str() <=> other.as_str();
     }
-}
 
-namespace raw
-{
+    [[nodiscard]] constexpr auto operator==(const String& other) const noexcept -> bool
+    {
+        if (this->m_len != other.m_len)
+        {
+            return false;
+        }
 
-/**
- * @brief A UTF-8 encoded, null-terminated, growable string with custom allocator support
- * @tparam Alloc The allocator type to use for memory management
- */
-template<typename Alloc = std::allocator<std::byte>>
-struct String
-{
-    using pointer = typename std::allocator_traits<Alloc>::pointer;
-    friend struct crab_cpp::str;
+        return std::equal(this->m_data, this->m_data + this->m_len, other.m_data);
+    }
 
-private:
-    pointer m_data = nullptr;
-    size_t m_len = 0;
-    compressed_pair<Alloc, size_t> m_alloc_and_capacity;
+    [[nodiscard]] constexpr auto operator==(const str& other) const noexcept -> bool
+    {
+        if (this->size() != other.size())
+        {
+            return false;
+        }
 
-    /**
-     * @brief Private constructor for internal use
-     */
-    String(const Alloc& alloc, pointer data, size_t len, size_t capacity) noexcept
-        : m_data(data), m_len(len), m_alloc_and_capacity(alloc, capacity) {}
+        return std::equal(this->data(), this->data() + this->size(), other.data());
+    }
 
-    /**
-     * @brief Allocates memory for the string
-     * @param capacity The capacity to allocate in bytes
-     */
-    auto allocate(size_t capacity) -> void
+    [[nodiscard]] constexpr auto operator==(const std::string& other) const noexcept -> bool
     {
-        if (capacity == 0)
+        if (this->size() != other.size())
         {
-            this->m_data = nullptr;
-            this->m_alloc_and_capacity.second = 0;
-            return;
+            return false;
         }
 
-        // Add 1 to capacity for null terminator
-        this->m_data = std::allocator_traits<Alloc>::allocate(
-            this->m_alloc_and_capacity.first(),
-            capacity + 1
-        );
-        this->m_alloc_and_capacity.second = capacity;
-        // Add null terminator
-        this->m_data[0] = std::byte{0};
+        return std::equal(this->data(), this->data() + this->size(), other.data());
     }
 
-// constructors
-public:
-    constexpr explicit String(const Alloc& alloc = Alloc()) noexcept : m_data(nullptr), m_len(0), m_alloc_and_capacity(alloc, 0) {}
-
-    constexpr String(const str& str, const Alloc& alloc = Alloc()) : String(alloc)
+    [[nodiscard]] constexpr auto operator==(const char* other) const noexcept -> bool
     {
-        (*this) += str;
+        if (this->size() != std::strlen(other))
+        {
+            return false;
+        }
+
+        return std::equal(this->data(), this->data() + this->size(), reinterpret_cast<const std::byte*>(other));
     }
 
-    constexpr String(const plain_str& str, const Alloc& alloc = Alloc()) : String(alloc)
+private:
+    /**
+     * @brief Makes room for additional bytes after the current length, growing the capacity geometrically
+     */
+    auto reserve_for_append(size_t additional) -> void
     {
-        (*this) += crab_cpp::str(str);
+        if (this->m_len + additional > this->m_alloc_and_capacity.second)
+        {
+            this->reserve(additional);
+        }
     }
 
-    template<typename View>
-        requires std::ranges::view<std::remove_reference_t<View>> &&
-            std::same_as<std::byte, std::remove_cv_t<typename std::iterator_traits<std::ranges::iterator_t<View>>::value_type>>
-    constexpr String(View&& view, const Alloc& alloc = Alloc()) : String(alloc)
+    /**
+     * @brief Appends a range of bytes without validating them, sized ranges grow the buffer once
+     */
+    template<std::ranges::input_range R>
+    auto append_bytes(R&& bytes) -> void
     {
-        this->reserve(64);
-        auto begin = view.cbegin();
-
-        size_t i = 0;
-        for (; begin != view.cend(); i += 1)
+        if constexpr (std::ranges::sized_range<R>)
         {
-            this->m_data[i] = *begin;
-            ++begin;
+            const auto len = size_t(std::ranges::size(bytes));
+            if (len == 0)
+            {
+                return;
+            }
 
-            if (i == this->m_alloc_and_capacity.second - 1)
+            this->reserve_for_append(len);
+            if constexpr (std::ranges::contiguous_range<R>)
             {
-                this->m_len = i + 1;
-                this->reserve(this->m_alloc_and_capacity.second / 2);
+                std::memcpy(this->m_data + this->m_len, std::ranges::data(bytes), len);
+            }
+            else
+            {
+                std::ranges::copy(bytes, this->m_data + this->m_len);
             }
-        }
-        this->m_len = i;
-        this->m_data[i + 1] = std::byte{0};
 
-        if (!is_valid_utf8(this->m_data, this->m_len))
+            this->finish_append(len);
+        }
+        else
         {
-            panic("Invalid UTF-8 sequence encountered while calling String constructor");
+            for (auto&& byte : bytes)
+            {
+                this->reserve_for_append(1);
+                this->m_data[this->m_len] = byte;
+                this->m_len += 1;
+            }
+
+            if (this->m_data != nullptr)
+            {
+                this->m_data[this->m_len] = std::byte{0};
+            }
         }
     }
 
     /**
-     * @brief Creates a string from a UTF-8 string
-     * @param str The input string
-     * @param len The length of the input string
-     * @param alloc The allocator to use
-     * @return A Result containing either a String or a FromUtf8Error
+     * @brief Creates a string of exactly len bytes, which write fills in place
      */
-    [[nodiscard]] static auto from_raw_parts(const char* str, size_t len, const Alloc& alloc = Alloc()) -> Result<String, FromUtf8Error>
+    template<typename F>
+    [[nodiscard]] static auto from_transcoded(size_t len, const Alloc& alloc, F&& write) -> String
     {
-        auto alloc_copy = alloc;
-
-        if (str == nullptr || len == 0)
-        {
-            return String(alloc_copy, nullptr, 0, 0);
-        }
-
-        auto result = str::from_raw_parts(str, len);
-        if (result.is_err())
+        auto string = String(alloc);
+        if (len == 0)
         {
-            return result.unwrap_err();
+            return string;
         }
 
-        pointer data = std::allocator_traits<Alloc>::allocate(alloc_copy, len);
-        std::copy(str, str + len, std::bit_cast<char*>(data));
+        string.reserve(len);
+        write(string.m_data);
+        string.finish_append(len);
 
-        return String(alloc_copy, data, len, len);
+        return string;
     }
 
     /**
-     * @brief Creates a string from a null-terminated, UTF-8 encoded C style string
-     * @param str The input string
-     * @param alloc The allocator to use
-     * @return A Result containing either a String or a FromUtf8Error
+     * @brief Commits len bytes written after the current length and adds the null terminator
      */
-    [[nodiscard]] static auto from(const char* str, const Alloc& alloc = Alloc()) -> Result<String, FromUtf8Error>
+    auto finish_append(size_t len) noexcept -> void
     {
-        return String::from_raw_parts(str, std::strlen(str), alloc);
-    }
+        // Appending nothing to a string that never allocated has no buffer to terminate
+        if (len == 0)
+        {
+            return;
+        }
 
-    String(const String& other)
-        : m_data(nullptr)
-        , m_len(0), m_alloc_and_capacity(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.m_alloc_and_capacity.first()), 0)
-    {
-        (*this) += other;
+        this->m_len += len;
+        this->m_data[this->m_len] = std::byte{0};
     }
 
-    String(String&& other) noexcept
-        : m_data(other.m_data), m_len(other.m_len), m_alloc_and_capacity(std::move(other.m_alloc_and_capacity))
+    /**
+     * For internal use
+     */
+    auto push_str_unchecked(const str& str) noexcept
     {
-        other.m_data = nullptr;
-        other.m_len = 0;
-        other.m_alloc_and_capacity.second = 0;
+        const size_t new_len = this->m_len + str.size();
+        std::copy(str.data(), str.data() + str.size(), this->m_data + this->m_len);
+
+        this->m_len = new_len;
+        // Add null terminator
+        this->m_data[this->m_len] = std::byte{0};
+
+        return *this;
     }
+};
 
-    ~String()
+}
+
+using String = raw::String<std::allocator<std::byte>>;
+
+/**
+ * @brief Formats the arguments and appends the result to a String.
+ * The output is formatted directly into the spare capacity, and only formatted a second time if it does not fit.
+ * @param string The String to append to
+ * @param fmt The format string
+ * @param args The arguments to format
+ */
+template<typename Alloc, typename ...Args>
+auto format_to(raw::String<Alloc>& string, std::format_string<Args...> fmt, Args&& ...args) -> void
+{
+    auto out = string.back_inserter();
+    auto spare = out.spare_capacity();
+
+    // Formatting never moves from the arguments, so forwarding them twice is fine
+    const auto result = std::format_to_n(spare.data(), spare.size(), fmt, std::forward<Args>(args)...);
+    const auto len = static_cast<size_t>(result.size);
+
+    if (len > spare.size())
     {
-        if (this->m_data != nullptr)
-        {
-            std::allocator_traits<Alloc>::deallocate(
-                this->m_alloc_and_capacity.first(),
-                this->m_data,
-                this->m_alloc_and_capacity.second + 1
-            );
-        }
+        out.reserve(len);
+        spare = out.spare_capacity();
+        std::format_to_n(spare.data(), spare.size(), fmt, std::forward<Args>(args)...);
     }
 
-// functions
-public:
+    out.commit(len);
+}
+
+/**
+ * @brief A clone-on-write string, holds either a borrowed str or an owned String
+ * @tparam Alloc The allocator type of the owned String
+ */
+template<typename Alloc = std::allocator<std::byte>>
+struct Cow : std::variant<str, raw::String<Alloc>>
+{
+    using std::variant<str, raw::String<Alloc>>::variant;
+
+    using std::variant<str, raw::String<Alloc>>::operator=;
+
     /**
-     * @brief Returns a byte slice of this String's contents
-     * @return A span containing the string's bytes
+     * @brief Returns true if the data is borrowed
      */
-    [[nodiscard]] constexpr auto as_bytes() const noexcept -> std::span<const std::byte>
+    [[nodiscard]] constexpr auto is_borrowed() const noexcept -> bool
     {
-        return std::span(
-            reinterpret_cast<const std::byte*>(this->m_data),
-        this->m_len
-        );
+        return this->index() == 0;
     }
 
     /**
-     * @brief Returns a byte slice of this String's contents
-     * @return A span containing the string's bytes
+     * @brief Returns true if the data is owned
      */
-    [[nodiscard]] constexpr auto as_raw() const noexcept -> const char*
+    [[nodiscard]] constexpr auto is_owned() const noexcept -> bool
     {
-        return reinterpret_cast<const char*>(this->m_data);
+        return this->index() == 1;
     }
 
     /**
-     * @brief Returns a byte slice of this String's contents
-     * @return A span containing the string's bytes
+     * @brief Returns the contents as a str, regardless of whether it is borrowed or owned
      */
     [[nodiscard]] constexpr auto as_str() const noexcept -> const str&
     {
-        return *(reinterpret_cast<const str*>(this));
+        if (this->is_borrowed())
+        {
+            return std::get<0>(*this);
+        }
+
+        return std::get<1>(*this).as_str();
     }
 
     /**
-     * @brief Returns a C-style string of this String's contents
-     * @return A C-style string of this String's contents
+     * @brief Extracts the owned data, copying the borrowed str into a new String if necessary
      */
-    [[nodiscard]] constexpr auto c_str() const noexcept -> const char*
+    [[nodiscard]] auto into_owned() && -> raw::String<Alloc>
     {
-        return std::bit_cast<const char*>(this->m_data);
+        if (this->is_borrowed())
+        {
+            return raw::String<Alloc>(std::get<0>(*this));
+        }
+
+        return std::move(std::get<1>(*this));
     }
 
     /**
-     * @brief Returns the current capacity of the buffer in bytes
-     * @return The capacity in bytes
+     * @brief Returns a mutable reference to the owned data, copying the borrowed str into a new String first if necessary
      */
-    [[nodiscard]] constexpr auto capacity() const noexcept -> size_t
+    auto to_mut() -> raw::String<Alloc>&
+    {
+        if (this->is_borrowed())
+        {
+            const str borrowed = std::get<0>(*this);
+            this->template emplace<1>(borrowed);
+        }
+
+        return std::get<1>(*this);
+    }
+
+//operators
+public:
+    [[nodiscard]] auto operator->() const noexcept -> const str*
+    {
+        return &this->as_str();
+    }
+
+    [[nodiscard]] constexpr auto operator==(const Cow& other) const noexcept -> bool
     {
-        return this->m_alloc_and_capacity.second;
+        return this->as_str() == other.as_str();
     }
 
-    /**
-     * @brief Clears the string content but keeps the allocated memory
-     */
-    constexpr auto clear() noexcept -> void
+    [[nodiscard]] constexpr auto operator==(const str& other) const noexcept -> bool
     {
-        this->m_len = 0;
+        return this->as_str() == other;
     }
 
-    /**
-     * @brief Returns a pointer to the string data
-     */
-    [[nodiscard]] constexpr auto data() const noexcept -> const std::byte*
+    [[nodiscard]] constexpr auto operator<=>(const Cow& other) const noexcept -> std::strong_ordering
     {
-        return this->m_data;
+        return this->as_str() <=> other.as_str();
     }
+};
+
+namespace raw
+{
+
+/**
+ * @brief An immutable, reference-counted UTF-8 string, copying it only bumps a counter.
+ * The counter, the bytes and a null terminator share one allocation, and the handle has the same (data, len) layout as str,
+ * so as_str() costs nothing. The empty string is never allocated.
+ * @tparam Atomic Whether the counter is atomic, so that copies may be shared between threads
+ */
+template<bool Atomic>
+struct SharedStr
+{
+private:
+    using Counter = std::conditional_t<Atomic, std::atomic<size_t>, size_t>;
+
+    const std::byte* m_data = nullptr;
+    size_t m_len = 0;
 
     /**
-     * @brief Returns a pointer to the string data
+     * @brief Returns the counter stored in front of the bytes, must not be called on the empty string
      */
-    [[nodiscard]] constexpr auto data() noexcept -> std::byte*
+    [[nodiscard]] auto counter() const noexcept -> Counter&
     {
-        return this->m_data;
+        return *std::bit_cast<Counter*>(this->m_data - sizeof(Counter));
     }
 
-    [[nodiscard]] constexpr auto empty() const noexcept -> bool
+    auto retain() const noexcept -> void
     {
-        return this->m_len == 0;
+        if (this->m_data == nullptr)
+        {
+            return;
+        }
+
+        if constexpr (Atomic)
+        {
+            this->counter().fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            this->counter() += 1;
+        }
     }
 
-    /**
-     * @brief Converts this string to its ASCII lower case equivalent in-place.
-     * ASCII letters 'A' to 'Z' are mapped to 'a' to 'z', but non-ASCII letters are unchanged.
-     */
-    auto make_ascii_lowercase() noexcept -> void
+    auto release() noexcept -> void
     {
-        for (size_t i = 0; i < this->m_len; i += 1)
+        if (this->m_data == nullptr)
         {
-            const auto ch = static_cast<std::uint8_t>(this->m_data[i]);
-            if (ch >= 65 && ch <= 90)
+            return;
+        }
+
+        if constexpr (Atomic)
+        {
+            if (this->counter().fetch_sub(1, std::memory_order_release) != 1)
             {
-                this->m_data[i] = static_cast<std::byte>(ch | 0x20);
+                return;
+            }
+
+            // Every other owner's accesses happen before the bytes are freed
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        else
+        {
+            if (--this->counter() != 0)
+            {
+                return;
             }
         }
+
+        std::destroy_at(&this->counter());
+        std::free(const_cast<std::byte*>(this->m_data - sizeof(Counter)));
     }
 
+public:
+    constexpr SharedStr() noexcept = default;
+
     /**
-     * @brief Converts this string to its ASCII lower case equivalent in-place.
-     * ASCII letters 'a' to 'z' are mapped to 'A' to 'Z', but non-ASCII letters are unchanged.
+     * @brief Copies the str into a new shared allocation
+     * @param s The str to copy
      */
-    auto make_ascii_uppercase() noexcept -> void
+    explicit SharedStr(const str& s)
     {
-        for (size_t i = 0; i < this->m_len; i += 1)
+        if (s.empty())
         {
-            const auto ch = static_cast<std::uint8_t>(this->m_data[i]);
-            if (ch >= 97 && ch <= 122)
-            {
-                this->m_data[i] = static_cast<std::byte>(ch & 0xDF);
-            }
+            return;
+        }
+
+        const auto block = static_cast<std::byte*>(std::malloc(sizeof(Counter) + s.size() + 1));
+        if (block == nullptr)
+        {
+            throw std::bad_alloc();
         }
+
+        std::construct_at(std::bit_cast<Counter*>(block), size_t(1));
+
+        const auto data = block + sizeof(Counter);
+        std::memcpy(data, s.data(), s.size());
+        data[s.size()] = std::byte{0};
+
+        this->m_data = data;
+        this->m_len = s.size();
     }
 
     /**
-     * @brief Returns the current length of the string in bytes
-     * @return The length in bytes
+     * @brief Copies the String into a new shared allocation
+     * @param s The String to copy
      */
-    [[nodiscard]] constexpr auto size() const noexcept -> size_t
+    template<typename Alloc>
+    explicit SharedStr(const raw::String<Alloc>& s) : SharedStr(s.as_str()) {}
+
+    SharedStr(const SharedStr& other) noexcept : m_data(other.m_data), m_len(other.m_len)
     {
-        return this->m_len;
+        this->retain();
     }
 
-    /**
-     * @brief Reserves capacity for at least additional bytes more than the current length.
-     * The allocator may reserve more space to speculatively avoid frequent allocations.
-     * After calling reserve, capacity will be greater than or equal to this->size() + additional.
-     * Does nothing if capacity is already sufficient.
-     * @param additional The number of additional bytes to reserve
-     * @note Panics if the new capacity overflows size_t
-     */
-    auto reserve(size_t additional) -> void
+    SharedStr(SharedStr&& other) noexcept : m_data(other.m_data), m_len(other.m_len)
     {
-        if (additional > 0 && additional < 16)
-        {
-            additional = 16;
-        }
+        other.m_data = nullptr;
+        other.m_len = 0;
+    }
 
-        const size_t new_capacity = this->size() + additional;
+    ~SharedStr()
+    {
+        this->release();
+    }
 
-        if (new_capacity < this->size())
-        {
-            panic("New capacity overflows in String::reserve");
-        }
+    auto operator=(const SharedStr& other) noexcept -> SharedStr&
+    {
+        other.retain();
+        this->release();
 
-        if (new_capacity <= this->m_alloc_and_capacity.second)
-        {
-            return;
-        }
+        this->m_data = other.m_data;
+        this->m_len = other.m_len;
 
-        // Allocate new memory (add 1 for null terminator)
-        pointer new_data = std::allocator_traits<Alloc>::allocate(
-            this->m_alloc_and_capacity.first(),
-            new_capacity + 1
-        );
+        return *this;
+    }
 
-        // Copy existing data
-        if (this->m_len > 0)
+    auto operator=(SharedStr&& other) noexcept -> SharedStr&
+    {
+        if (this != &other)
         {
-            std::copy(this->m_data,
-                    this->m_data + this->m_len,
-                    new_data);
-        }
-        // Add null terminator
-        new_data[this->m_len] = std::byte{0};
+            this->release();
 
-        // Deallocate old memory
-        if (this->m_data != nullptr)
-        {
-            std::allocator_traits<Alloc>::deallocate(
-                this->m_alloc_and_capacity.first(),
-                this->m_data,
-                this->m_alloc_and_capacity.second + 1
-            );
+            this->m_data = std::exchange(other.m_data, nullptr);
+            this->m_len = std::exchange(other.m_len, 0);
         }
 
-        // Update members
-        this->m_data = new_data;
-        this->m_alloc_and_capacity.second = new_capacity;
+        return *this;
     }
 
+// functions
+public:
     /**
-     * @brief Appends the given Char to the end of this String.
-     * @param ch The Char to append
+     * @brief Returns the contents as a str
      */
-    auto push(Char ch) -> void
+    [[nodiscard]] constexpr auto as_str() const noexcept -> const str&
     {
-        (*this) += ch;
+        return *(reinterpret_cast<const str*>(this));
     }
 
     /**
-     * @brief Appends a given str onto the end of this String.
-     * @param str The str to append
+     * @brief Returns a null-terminated C string of the contents
      */
-    auto push_str(const str& str) -> void
+    [[nodiscard]] constexpr auto c_str() const noexcept -> const char*
     {
-        (*this) += str;
+        return this->m_data == nullptr ? "" : std::bit_cast<const char*>(this->m_data);
     }
 
-    /**
-     * @brief Splits the string into two at the given byte index
-     * @param at The byte index at which to split
-     * @return A newly allocated String containing bytes [at, len)
-     * @note Panics If at is not on a UTF-8 code point boundary, or if it is beyond the last code point
-     */
-    auto split_off(size_t at) -> String
+    [[nodiscard]] constexpr auto size() const noexcept -> size_t
     {
-        if (at >= this->m_len)
-        {
-            panic("Split index out of bounds");
-        }
-
-        // Verify that 'at' is on a UTF-8 code point boundary
-        if (!is_valid_utf8(this->m_data, at) ||
-            !is_valid_utf8(this->m_data + at, this->m_len - at))
-        {
-            panic("Split index not on UTF-8 code point boundary");
-        }
-
-        // Create new string with the second part
-        String result(this->m_alloc_and_capacity.first(), nullptr, 0, 0);
-        result.reserve(this->m_len - at);
-
-        // Copy the bytes [at, len) to the new string
-        std::copy(this->m_data + at,
-                 this->m_data + this->m_len,
-                 result.m_data);
-        result.m_len = this->m_len - at;
-        // Add null terminator to the new string
-        result.m_data[result.m_len] = std::byte{0};
-
-        // Update this string's length and add null terminator
-        this->m_len = at;
-        this->m_data[this->m_len] = std::byte{0};
+        return this->m_len;
+    }
 
-        return result;
+    [[nodiscard]] constexpr auto empty() const noexcept -> bool
+    {
+        return this->m_len == 0;
     }
 
     /**
-     * @brief Shortens this String to the specified length.
-     * @details If new_len is greater than or equal to the string's current length, this has no effect.
-     *          Note that this method has no effect on the allocated capacity of the string
-     * @param new_len The new length of the string
-     * @note Panics if new_len does not lie on a char boundary.
+     * @brief Returns the number of handles sharing the allocation, 0 for the empty string which is never allocated
      */
-    auto truncate(size_t new_len) noexcept -> void
+    [[nodiscard]] auto use_count() const noexcept -> size_t
     {
-        if (new_len >= this->m_len)
+        if (this->m_data == nullptr)
         {
-            return;
+            return 0;
         }
 
-        if (!is_valid_utf8(this->m_data, new_len))
+        if constexpr (Atomic)
         {
-            panic("Invalid UTF-8 sequence while calling String::truncate");
+            return this->counter().load(std::memory_order_relaxed);
+        }
+        else
+        {
+            return this->counter();
         }
-
-        this->m_len = new_len;
-        this->m_data[this->m_len] = std::byte{0};
     }
 
     /**
-     * @brief Removes the last character from the string buffer and returns it
-     * @return Option containing the removed character, or None if the string is empty
+     * @brief Returns true if both handles share the same allocation
      */
-    [[nodiscard]] auto pop() noexcept -> Option<Char>
+    [[nodiscard]] constexpr auto ptr_eq(const SharedStr& other) const noexcept -> bool
     {
-        if (this->m_len == 0)
-        {
-            return None{};
-        }
-
-        // Find the start of the last UTF-8 sequence by scanning backwards
-        size_t start = this->m_len - 1;
-        while (start > 0 && (this->m_data[start] & std::byte{0xC0}) == std::byte{0x80})
-        {
-            start -= 1;
-        }
-
-        // Decode the UTF-8 sequence
-        utf8proc_int32_t codepoint = 0;
-        utf8proc_iterate(
-            reinterpret_cast<const utf8proc_uint8_t*>(this->m_data + start),
-            this->m_len - start,
-            &codepoint
-        );
-
-        // Update string length
-        this->m_len = start;
-        // Add null terminator at new end
-        this->m_data[this->m_len] = std::byte{0};
-
-        return Char(static_cast<std::uint32_t>(codepoint));
+        return this->m_data == other.m_data;
     }
 
 //operators
 public:
-    [[nodiscard]] auto operator->() noexcept -> str*
+    [[nodiscard]] auto operator->() const noexcept -> const str*
     {
-        return std::bit_cast<str*>(this);
+        return &this->as_str();
     }
 
-    [[nodiscard]] auto operator->() const noexcept -> const str*
+    [[nodiscard]] constexpr auto operator==(const SharedStr& other) const noexcept -> bool
     {
-        return std::bit_cast<const str*>(this);
+        return this->as_str() == other.as_str();
     }
 
-    auto operator=(const String& other) -> String&
+    [[nodiscard]] constexpr auto operator==(const str& other) const noexcept -> bool
     {
-        this->clear();
-        (*this) += other;
+        return this->as_str() == other;
+    }
 
-        return *this;
+    [[nodiscard]] constexpr auto operator<=>(const SharedStr& other) const noexcept -> std::strong_ordering
+    {
+        return this->as_str() <=> other.as_str();
     }
+};
+
+}
+
+/**
+ * @brief An immutable string with an atomic reference count, copies can be handed to other threads
+ */
+using ArcStr = raw::SharedStr<true>;
+
+/**
+ * @brief An immutable string with a non-atomic reference count, for use within a single thread
+ */
+using RcStr = raw::SharedStr<false>;
+
+/**
+ * @brief A UTF-8 string of at most N bytes stored inline, without an allocator.
+ * It is trivially copyable, so arrays of it can be copied with memcpy, and appending past the capacity returns an error.
+ * @tparam N The capacity in bytes
+ */
+template<size_t N>
+struct InlineString
+{
+private:
+    using Len = std::conditional_t<N <= std::numeric_limits<std::uint8_t>::max(), std::uint8_t,
+        std::conditional_t<N <= std::numeric_limits<std::uint16_t>::max(), std::uint16_t,
+        std::conditional_t<N <= std::numeric_limits<std::uint32_t>::max(), std::uint32_t, size_t>>>;
+
+    std::array<std::byte, N + 1> m_data = {};
+    Len m_len = 0;
 
     /**
-     * @brief Appends the given Char to the end of this String.
-     * @param ch The Char to append
-     * @return A reference to this String
+     * @brief Appends the bytes if they fit, they must keep the string valid UTF-8
      */
-    auto operator+=(const Char ch) -> String&
+    constexpr auto append(const std::byte* data, size_t len) noexcept -> Result<size_t, CapacityError>
     {
-        // Convert Unicode scalar value to UTF-8
-        utf8proc_uint8_t utf8[4];
-        const auto len = utf8proc_encode_char(
-            static_cast<utf8proc_int32_t>(ch.code_point()),
-            utf8
-        );
-
-        if (len < 0)
+        if (len > N - this->m_len)
         {
-            panic("Failed to encode Unicode scalar value to UTF-8");
-        }
-
-        const size_t new_len = this->m_len + static_cast<size_t>(len);
-        if (new_len > this->m_alloc_and_capacity.second)
-        {
-            this->reserve(new_len - this->m_alloc_and_capacity.second);
+            return CapacityError(this->m_len + len, N);
         }
 
-        std::copy(utf8, utf8 + len, reinterpret_cast<utf8proc_uint8_t*>(this->m_data + this->m_len));
-        this->m_len = new_len;
-        // Add null terminator
+        std::copy(data, data + len, this->m_data.data() + this->m_len);
+        this->m_len += static_cast<Len>(len);
         this->m_data[this->m_len] = std::byte{0};
 
-        return *this;
+        return size_t(this->m_len);
     }
 
+public:
     /**
-     * @brief Appends a str to this String using the += operator
-     * @param str The str to append
-     * @return A reference to this String
+     * @brief Holds the str that operator-> points to, since the inline bytes have no str of their own
      */
-    auto operator+=(const String& str) -> String&
+    struct Arrow
     {
-        return (*this) += str.as_str();
-    }
+        str s;
 
-    /**
-     * @brief Appends a str to this String using the += operator
-     * @param str The str to append
-     * @return A reference to this String
-     */
-    auto operator+=(const str& str) -> String&
-    {
-        if (str.empty())
+        [[nodiscard]] constexpr auto operator->() const noexcept -> const str*
         {
-            return *this;
+            return &this->s;
         }
+    };
 
-        const size_t new_len = this->m_len + str.size();
-        if (new_len > this->m_alloc_and_capacity.second)
+// constructors
+public:
+    constexpr InlineString() noexcept = default;
+
+    /**
+     * @brief Creates an InlineString holding a copy of the str
+     * @param s The str to copy
+     * @return A Result containing either the InlineString or a CapacityError if s is longer than N bytes
+     */
+    [[nodiscard]] static constexpr auto from(const str& s) noexcept -> Result<InlineString, CapacityError>
+    {
+        auto string = InlineString();
+        const auto result = string.push_str(s);
+        if (result.is_err())
         {
-            this->reserve(new_len - this->m_alloc_and_capacity.second);
+            return result.unwrap_err();
         }
 
-        std::copy(str.data(), str.data() + str.size(), this->m_data + this->m_len);
-        this->m_len = new_len;
-        // Add null terminator
-        this->m_data[this->m_len] = std::byte{0};
+        return string;
+    }
 
-        return *this;
+// functions
+public:
+    /**
+     * @brief Returns the contents as a str
+     */
+    [[nodiscard]] constexpr auto as_str() const noexcept -> str
+    {
+        return str::from_bytes_unchecked(this->m_data.data(), this->m_len);
     }
 
     /**
-     * @brief Appends a C-string to this String using the += operator
-     * @param str The C-string to append
-     * @return A reference to this String
+     * @brief Returns a null-terminated C string of the contents
      */
-    auto operator+=(const char* str) -> String&
+    [[nodiscard]] constexpr auto c_str() const noexcept -> const char*
     {
-        return (*this) += str::from(str).expect("Invalid UTF-8 sequence while calling String::operator+=");
+        return std::bit_cast<const char*>(this->m_data.data());
     }
 
-    auto operator+(const String& str) -> String
+    [[nodiscard]] constexpr auto size() const noexcept -> size_t
     {
-        return (*this) + str.as_str();
+        return this->m_len;
     }
 
-    auto operator+(const str& str) -> String
+    [[nodiscard]] constexpr auto empty() const noexcept -> bool
     {
-        auto string = String();
-        string.reserve(this->m_len + str.size());
-        string += *this;
-        string += str;
+        return this->m_len == 0;
+    }
 
-        return string;
+    [[nodiscard]] static constexpr auto capacity() noexcept -> size_t
+    {
+        return N;
     }
 
-    auto operator+(const Char ch) -> String
+    /**
+     * @brief Appends the given Char to the end of this InlineString
+     * @param ch The Char to append
+     * @return A Result containing either the new length or a CapacityError if the Char does not fit, in which case
+     *         the string is left unchanged
+     */
+    auto push(Char ch) noexcept -> Result<size_t, CapacityError>
     {
-        auto string = String();
-        string.reserve(this->m_len + sizeof(Char));
-        string += *this;
-        string += ch;
+        std::array<std::byte, 4> encoded;
+        const auto len = utf8proc_encode_char(static_cast<utf8proc_int32_t>(ch.code_point()), reinterpret_cast<utf8proc_uint8_t*>(encoded.data()));
 
-        return string;
+        return this->append(encoded.data(), size_t(len));
     }
 
-    auto operator+(const char* str) -> String
+    /**
+     * @brief Appends a given str onto the end of this InlineString
+     * @param s The str to append
+     * @return A Result containing either the new length or a CapacityError if the str does not fit, in which case
+     *         the string is left unchanged
+     */
+    constexpr auto push_str(const str& s) noexcept -> Result<size_t, CapacityError>
     {
-        return (*this) + str::from(str).expect("Invalid UTF-8 sequence while calling String::operator+=");
+        return this->append(s.data(), s.size());
     }
 
-    [[nodiscard]] constexpr auto operator<=>(const String& other) const noexcept -> std::strong_ordering
+    /**
+     * @brief Clears the contents
+     */
+    constexpr auto clear() noexcept -> void
     {
-        return this->as_str() <=> other.as_str();
+        this->m_len = 0;
+        this->m_data[0] = std::byte{0};
     }
 
-    [[nodiscard]] constexpr auto operator==(const String& other) const noexcept -> bool
+//operators
+public:
+    [[nodiscard]] constexpr auto operator->() const noexcept -> Arrow
     {
-        if (this->m_len != other.m_len)
-        {
-            return false;
-        }
+        return Arrow(this->as_str());
+    }
 
-        return std::equal(this->m_data, this->m_data + this->m_len, other.m_data);
+    [[nodiscard]] constexpr auto operator==(const InlineString& other) const noexcept -> bool
+    {
+        return this->as_str() == other.as_str();
     }
 
     [[nodiscard]] constexpr auto operator==(const str& other) const noexcept -> bool
     {
-        if (this->size() != other.size())
-        {
-            return false;
-        }
+        return this->as_str() == other;
+    }
 
-        return std::equal(this->data(), this->data() + this->size(), other.data());
+    [[nodiscard]] constexpr auto operator<=>(const InlineString& other) const noexcept -> std::strong_ordering
+    {
+        return this->as_str() <=> other.as_str();
     }
+};
 
-    [[nodiscard]] constexpr auto operator==(const std::string& other) const noexcept -> bool
+/**
+ * @brief Builds a String from UTF-8 input that arrives in chunks, each byte is validated exactly once
+ * @details Complete characters are appended as soon as their chunk arrives, a sequence cut at the end
+ *          of a chunk is held back until the following chunk completes it.
+ * @tparam Alloc The allocator type of the String being built
+ */
+template<typename Alloc = std::allocator<std::byte>>
+struct Utf8Decoder
+{
+private:
+    raw::String<Alloc> m_string;
+    Utf8Validator m_validator;
+    std::byte m_pending[4] = {};
+    size_t m_pending_len = 0;
+
+public:
+    explicit Utf8Decoder(const Alloc& alloc = Alloc()) : m_string(alloc) {}
+
+    /**
+     * @brief Validates the next chunk and appends its complete characters to the String
+     * @param chunk The bytes following the previously pushed ones
+     * @return The total number of bytes appended so far, or a FromUtf8Error with the absolute position of the first invalid sequence
+     */
+    auto push(std::span<const std::byte> chunk) -> Result<size_t, FromUtf8Error>
     {
-        if (this->size() != other.size())
+        const auto result = this->m_validator.feed(chunk);
+        if (result.is_err())
         {
-            return false;
+            return result;
         }
 
-        return std::equal(this->data(), this->data() + this->size(), other.data());
-    }
+        const size_t total = this->m_pending_len + chunk.size();
+        const size_t commit = total - this->m_validator.pending_len();
+        const size_t from_pending = std::min(commit, this->m_pending_len);
 
-    [[nodiscard]] constexpr auto operator==(const char* other) const noexcept -> bool
-    {
-        if (this->size() != std::strlen(other))
+        this->m_string += str::from_bytes_unchecked(this->m_pending, from_pending);
+        this->m_string += str::from_bytes_unchecked(chunk.data(), commit - from_pending);
+
+        // Keep the incomplete sequence, which may start in an earlier chunk
+        std::byte tail[4] = {};
+        for (size_t i = commit; i < total; i += 1)
         {
-            return false;
+            tail[i - commit] = i < this->m_pending_len ? this->m_pending[i] : chunk[i - this->m_pending_len];
         }
+        std::copy(tail, tail + (total - commit), this->m_pending);
+        this->m_pending_len = total - commit;
 
-        return std::equal(this->data(), this->data() + this->size(), reinterpret_cast<const std::byte*>(other));
+        return result;
     }
 
-private:
     /**
-     * For internal use
+     * @brief Validates the next chunk and appends its complete characters to the String
+     * @see Utf8Decoder::push(std::span<const std::byte>)
      */
-    auto push_str_unchecked(const str& str) noexcept
+    auto push(const char* data, size_t len) -> Result<size_t, FromUtf8Error>
     {
-        const size_t new_len = this->m_len + str.size();
-        std::copy(str.data(), str.data() + str.size(), this->m_data + this->m_len);
-
-        this->m_len = new_len;
-        // Add null terminator
-        this->m_data[this->m_len] = std::byte{0};
+        return this->push(std::span(std::bit_cast<const std::byte*>(data), len));
+    }
 
-        return *this;
+    /**
+     * @brief Reserves capacity for at least additional more bytes in the String being built
+     */
+    auto reserve(size_t additional) -> void
+    {
+        this->m_string.reserve(additional);
     }
-};
 
-}
+    /**
+     * @brief Ends the input and returns the String
+     * @return The String, or a FromUtf8Error if the input is invalid or ends in the middle of a sequence
+     */
+    [[nodiscard]] auto finish() && -> Result<raw::String<Alloc>, FromUtf8Error>
+    {
+        const auto result = this->m_validator.finish();
+        if (result.is_err())
+        {
+            return result.unwrap_err();
+        }
 
-using String = raw::String<std::allocator<std::byte>>;
+        return std::move(this->m_string);
+    }
+};
 
 template<typename Alloc = std::allocator<std::byte>>
 [[nodiscard]] constexpr auto operator==(const str& lhs, const raw::String<Alloc>& rhs) noexcept -> bool
@@ -2687,42 +7355,90 @@ struct std::formatter<crab_cpp::Char> : std::formatter<std::uint32_t>
 
 export auto operator<<(std::ostream& os, const crab_cpp::Char& ch) -> std::ostream&
 {
-    const std::ios_base::fmtflags original_base = std::cout.flags() & std::ios_base::basefield;
+    const auto original_flags = os.flags();
     os << std::hex << "u" << ch.code_point();
-    std::cout.flags(original_base);
+    os.flags(original_flags);
 
     return os;
 }
 
+/**
+ * @brief Formats a str from its length, so slices that are not null-terminated are formatted correctly.
+ * Width, fill, alignment and precision work as for std::string_view, measured in estimated display width of
+ * grapheme clusters.
+ */
 template<>
-struct std::formatter<crab_cpp::str> : std::formatter<const char*>
+struct std::formatter<crab_cpp::str> : std::formatter<std::string_view>
 {
-    static auto format(const crab_cpp::str& str, std::format_context& ctx)
+    auto format(const crab_cpp::str& str, std::format_context& ctx) const
     {
-        return std::format_to(ctx.out(), "{}", std::string_view(str.as_raw(), str.size()));
+        return std::formatter<std::string_view>::format(std::string_view(str.as_raw(), str.size()), ctx);
     }
 };
 
 export auto operator<<(std::ostream& os, const crab_cpp::str& str) -> std::ostream&
 {
-    os << std::string_view(str.as_raw(), str.size());
-    return os;
+    return os << std::string_view(str.as_raw(), str.size());
 }
 
 template<typename Alloc>
-struct std::formatter<crab_cpp::raw::String<Alloc>> : std::formatter<const char*>
+struct std::formatter<crab_cpp::raw::String<Alloc>> : std::formatter<crab_cpp::str>
 {
-    static auto format(const crab_cpp::raw::String<Alloc>& str, std::format_context& ctx)
+    auto format(const crab_cpp::raw::String<Alloc>& str, std::format_context& ctx) const
     {
-        return std::format_to(ctx.out(), "{}", std::string_view(reinterpret_cast<const char*>(str.data()), str.size()));
+        return std::formatter<crab_cpp::str>::format(str.as_str(), ctx);
     }
 };
 
 export template<typename Alloc>
 auto operator<<(std::ostream& os, const crab_cpp::raw::String<Alloc>& str) -> std::ostream&
 {
-    os << std::string_view(reinterpret_cast<const char*>(str.data()), str.size());
-    return os;
+    return os << str.as_str();
+}
+
+template<typename Alloc>
+struct std::formatter<crab_cpp::Cow<Alloc>> : std::formatter<crab_cpp::str>
+{
+    auto format(const crab_cpp::Cow<Alloc>& str, std::format_context& ctx) const
+    {
+        return std::formatter<crab_cpp::str>::format(str.as_str(), ctx);
+    }
+};
+
+export template<typename Alloc>
+auto operator<<(std::ostream& os, const crab_cpp::Cow<Alloc>& str) -> std::ostream&
+{
+    return os << str.as_str();
+}
+
+template<bool Atomic>
+struct std::formatter<crab_cpp::raw::SharedStr<Atomic>> : std::formatter<crab_cpp::str>
+{
+    auto format(const crab_cpp::raw::SharedStr<Atomic>& str, std::format_context& ctx) const
+    {
+        return std::formatter<crab_cpp::str>::format(str.as_str(), ctx);
+    }
+};
+
+export template<bool Atomic>
+auto operator<<(std::ostream& os, const crab_cpp::raw::SharedStr<Atomic>& str) -> std::ostream&
+{
+    return os << str.as_str();
+}
+
+template<size_t N>
+struct std::formatter<crab_cpp::InlineString<N>> : std::formatter<crab_cpp::str>
+{
+    auto format(const crab_cpp::InlineString<N>& str, std::format_context& ctx) const
+    {
+        return std::formatter<crab_cpp::str>::format(str.as_str(), ctx);
+    }
+};
+
+export template<size_t N>
+auto operator<<(std::ostream& os, const crab_cpp::InlineString<N>& str) -> std::ostream&
+{
+    return os << str.as_str();
 }
 
 template<>
@@ -2751,3 +7467,140 @@ struct std::hash<crab_cpp::raw::String<Alloc>>
 		return std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char*>(str.data()), str.size()));
 	}
 };
+
+template<typename Alloc>
+struct std::hash<crab_cpp::Cow<Alloc>>
+{
+    auto operator()(const crab_cpp::Cow<Alloc>& str) const noexcept -> size_t
+    {
+		return std::hash<crab_cpp::str>{}(str.as_str());
+	}
+};
+
+template<bool Atomic>
+struct std::hash<crab_cpp::raw::SharedStr<Atomic>>
+{
+    auto operator()(const crab_cpp::raw::SharedStr<Atomic>& str) const noexcept -> size_t
+    {
+		return std::hash<crab_cpp::str>{}(str.as_str());
+	}
+};
+
+template<size_t N>
+struct std::hash<crab_cpp::InlineString<N>>
+{
+    auto operator()(const crab_cpp::InlineString<N>& str) const noexcept -> size_t
+    {
+		return std::hash<crab_cpp::str>{}(str.as_str());
+	}
+};
+
+// The views of str hold the bytes by value and their iterators never point back into the view,
+// the views are named through decltype since their types are private to str
+namespace crab_cpp::str_detail
+{
+
+using Chars = decltype(std::declval<const crab_cpp::str&>().chars());
+using Lines = decltype(std::declval<const crab_cpp::str&>().lines());
+using Matches = decltype(std::declval<const crab_cpp::str&>().matches(std::declval<const crab_cpp::str&>()));
+using Split = decltype(std::declval<const crab_cpp::str&>().split(std::declval<const crab_cpp::str&>()));
+using SplitASCIIWhiteSpace = decltype(std::declval<const crab_cpp::str&>().split_ascii_whitespace());
+using Graphemes = decltype(std::declval<const crab_cpp::str&>().graphemes());
+using EncodeUtf16 = decltype(std::declval<const crab_cpp::str&>().encode_utf16());
+using SplitN = decltype(std::declval<const crab_cpp::str&>().splitn(0, std::declval<const crab_cpp::str&>()));
+using RSplitN = decltype(std::declval<const crab_cpp::str&>().rsplitn(0, std::declval<const crab_cpp::str&>()));
+using SplitTerminator = decltype(std::declval<const crab_cpp::str&>().split_terminator(std::declval<const crab_cpp::str&>()));
+using SplitInclusive = decltype(std::declval<const crab_cpp::str&>().split_inclusive(std::declval<const crab_cpp::str&>()));
+
+}
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<crab_cpp::str_detail::Chars> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<crab_cpp::str_detail::Lines> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<crab_cpp::str_detail::Matches> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<crab_cpp::str_detail::Split> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<crab_cpp::str_detail::SplitASCIIWhiteSpace> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<crab_cpp::str_detail::Graphemes> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<crab_cpp::str_detail::EncodeUtf16> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<crab_cpp::str_detail::SplitN> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<crab_cpp::str_detail::RSplitN> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<crab_cpp::str_detail::SplitTerminator> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<crab_cpp::str_detail::SplitInclusive> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<crab_cpp::FinderMatches> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<crab_cpp::FinderSplit> = true;
+
+template<crab_cpp::Pattern P>
+inline constexpr bool std::ranges::enable_borrowed_range<crab_cpp::str::PatternMatchesView<P>> = true;
+
+template<crab_cpp::Pattern P>
+inline constexpr bool std::ranges::enable_borrowed_range<crab_cpp::str::PatternSplitView<P>> = true;
+
+
+template<>
+inline constexpr bool std::ranges::enable_view<crab_cpp::str_detail::Chars> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_view<crab_cpp::str_detail::Lines> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_view<crab_cpp::str_detail::Matches> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_view<crab_cpp::str_detail::Split> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_view<crab_cpp::str_detail::SplitASCIIWhiteSpace> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_view<crab_cpp::str_detail::Graphemes> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_view<crab_cpp::str_detail::EncodeUtf16> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_view<crab_cpp::str_detail::SplitN> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_view<crab_cpp::str_detail::RSplitN> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_view<crab_cpp::str_detail::SplitTerminator> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_view<crab_cpp::str_detail::SplitInclusive> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_view<crab_cpp::FinderMatches> = true;
+
+template<>
+inline constexpr bool std::ranges::enable_view<crab_cpp::FinderSplit> = true;
+
+template<crab_cpp::Pattern P>
+inline constexpr bool std::ranges::enable_view<crab_cpp::str::PatternMatchesView<P>> = true;
+
+template<crab_cpp::Pattern P>
+inline constexpr bool std::ranges::enable_view<crab_cpp::str::PatternSplitView<P>> = true;
@@ -0,0 +1,80 @@
+#ifdef CRAB_CPP_ENABLE_STRING
+
+#include <gtest/gtest.h>
+
+import crab_cpp;
+import std;
+
+using namespace crab_cpp;
+
+namespace
+{
+    auto write_temp_file(std::string_view name, std::string_view content) -> std::filesystem::path
+    {
+        const auto path = std::filesystem::temp_directory_path() / name;
+        std::ofstream(path, std::ios::binary) << content;
+
+        return path;
+    }
+}
+
+TEST(FsTest, MapStr)
+{
+    using namespace literal;
+
+    const auto path = write_temp_file("crab_cpp_map_str.txt", "Hello\nWörld\n");
+    auto mapped = fs::map_str(path);
+    EXPECT_TRUE(mapped.is_ok());
+    EXPECT_EQ(mapped.unwrap().as_str(), "Hello\nWörld\n"_s);
+    EXPECT_TRUE(mapped.unwrap()->starts_with("Hello"_s));
+    EXPECT_EQ(mapped.unwrap().size(), 13);
+
+    // Test empty file
+    const auto empty_path = write_temp_file("crab_cpp_map_str_empty.txt", "");
+    auto empty = fs::map_str(empty_path);
+    EXPECT_TRUE(empty.is_ok());
+    EXPECT_TRUE(empty.unwrap().as_str().empty());
+
+    // Test invalid UTF-8
+    const auto invalid_path = write_temp_file("crab_cpp_map_str_invalid.txt", "abc\xC0\x80");
+    auto invalid = fs::map_str(invalid_path);
+    EXPECT_TRUE(invalid.is_err());
+    EXPECT_EQ(invalid.unwrap_err().kind(), fs::Error::Kind::InvalidUtf8);
+    EXPECT_EQ(invalid.unwrap_err().utf8_error().unwrap().pos, 3);
+
+    // Test missing file
+    auto missing = fs::map_str(std::filesystem::temp_directory_path() / "crab_cpp_does_not_exist.txt");
+    EXPECT_TRUE(missing.is_err());
+    EXPECT_EQ(missing.unwrap_err().kind(), fs::Error::Kind::Io);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(empty_path);
+    std::filesystem::remove(invalid_path);
+}
+
+TEST(FsTest, MapStrLazy)
+{
+    using namespace literal;
+
+    const auto path = write_temp_file("crab_cpp_map_str_lazy.txt", "first\r\nsec\xFFnd\nthird");
+    auto result = fs::map_str_lazy(path);
+    auto mapped = std::move(result.unwrap());
+
+    auto lines = mapped.lines();
+    auto it = lines.begin();
+    EXPECT_EQ(it->unwrap(), "first"_s);
+    ++it;
+    EXPECT_EQ(it->unwrap_err().pos, 10);
+    ++it;
+    EXPECT_EQ(it->unwrap(), "third"_s);
+    ++it;
+    EXPECT_EQ(it, lines.end());
+
+    EXPECT_EQ(mapped.slice(0, 5).unwrap(), "first"_s);
+    EXPECT_EQ(mapped.slice(7, 13).unwrap_err().pos, 10);
+    EXPECT_TRUE(std::move(mapped).validate().is_err());
+
+    std::filesystem::remove(path);
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifdef CRAB_CPP_ENABLE_STRING
+
+#include <gtest/gtest.h>
+
+import crab_cpp;
+import std;
+
+using namespace crab_cpp;
+
+TEST(ParTest, ParMatches)
+{
+    using namespace literal;
+
+    const auto options = ParOptions{ .threads = 4, .chunk_size = 3 };
+
+    auto s = "abababab"_s;
+    auto pattern = "aba"_s;
+    auto expected = s.matches(pattern) | std::ranges::to<std::vector<size_t>>();
+    EXPECT_EQ(par_matches(s, pattern, options), expected);
+    EXPECT_EQ(par_matches(s, pattern, options), (std::vector<size_t>{0, 4}));
+
+    EXPECT_EQ(par_matches("aaaaaaa"_s, "aa"_s, options), (std::vector<size_t>{0, 2, 4}));
+    EXPECT_TRUE(par_matches(s, ""_s, options).empty());
+    EXPECT_TRUE(par_matches(s, "c"_s, options).empty());
+}
+
+TEST(ParTest, ParLines)
+{
+    using namespace literal;
+
+    const auto options = ParOptions{ .threads = 4, .chunk_size = 4 };
+
+    auto s = "Hello\r\nWorld\n\nfoo\nbar"_s;
+    auto lines = par_lines(s, [](str line) { return line.size(); }, options);
+    EXPECT_EQ(lines, (std::vector<size_t>{5, 5, 0, 3, 3}));
+
+    auto total = std::atomic<size_t>(0);
+    par_lines_for_each(s, [&](str line) { total += line.size(); }, options);
+    EXPECT_EQ(total, 16);
+
+    EXPECT_EQ(par_lines(""_s, [](str line) { return line.size(); }, options), (std::vector<size_t>{0}));
+}
+
+TEST(ParTest, ParSplit)
+{
+    using namespace literal;
+
+    const auto options = ParOptions{ .threads = 4, .chunk_size = 2 };
+
+    auto s = " Hello World  foo "_s;
+    auto parts = par_split(s, " "_s, [](str part) { return part.to_std_string(); }, options);
+    EXPECT_EQ(parts, (std::vector<std::string>{"", "Hello", "World", "", "foo"}));
+
+    auto count = std::atomic<size_t>(0);
+    par_split_for_each(s, " "_s, [&](str) { count++; }, options);
+    EXPECT_EQ(count, 5);
+
+    EXPECT_EQ(par_split(s, ""_s, [](str part) { return part.size(); }, options), (std::vector<size_t>{s.size()}));
+}
+
+#endif
@@ -0,0 +1,108 @@
+#ifdef CRAB_CPP_ENABLE_STRING
+
+#include <gtest/gtest.h>
+
+import crab_cpp;
+import std;
+
+using namespace crab_cpp;
+
+TEST(RopeTest, InsertRemove)
+{
+    using namespace literal;
+
+    auto rope = Rope::from("Hello World"_s);
+    EXPECT_EQ(rope.size(), 11);
+    EXPECT_EQ(rope, "Hello World"_s);
+
+    rope.insert(5, ","_s);
+    rope.push_str("!"_s);
+    EXPECT_EQ(rope, "Hello, World!"_s);
+
+    rope.remove(5, 12);
+    EXPECT_EQ(rope, "Hello!"_s);
+
+    rope.remove(0, rope.size());
+    EXPECT_TRUE(rope.empty());
+    EXPECT_EQ(rope, ""_s);
+
+    // Test a text spanning many chunks
+    auto text = String();
+    for (int32_t i = 0; i < 10000; i += 1)
+    {
+        text.push_int(i);
+        text.push_str("\n"_s);
+    }
+
+    auto big = Rope::from(text);
+    EXPECT_EQ(big.size(), text.size());
+    EXPECT_EQ(big.to_string(), text);
+
+    big.insert(text.size() / 2 - 1, "héllo"_s);
+    big.remove(text.size() / 2 - 1, text.size() / 2 + 5);
+    EXPECT_EQ(big.to_string(), text);
+
+    auto copy = big;
+    copy.remove(0, 10);
+    EXPECT_EQ(big.size(), text.size());
+    EXPECT_EQ(copy.size(), text.size() - 10);
+}
+
+TEST(RopeTest, Indices)
+{
+    using namespace literal;
+
+    auto rope = Rope::from("aé世\n\U0001F600b\nc"_s);
+    EXPECT_EQ(rope.char_count(), 8);
+    EXPECT_EQ(rope.newline_count(), 2);
+
+    EXPECT_EQ(rope.char_to_byte(0), 0);
+    EXPECT_EQ(rope.char_to_byte(2), 3);
+    EXPECT_EQ(rope.char_to_byte(4), 7);
+    EXPECT_EQ(rope.char_to_byte(8), rope.size());
+    EXPECT_EQ(rope.byte_to_char(7), 4);
+
+    EXPECT_EQ(rope.line_to_byte(0), 0);
+    EXPECT_EQ(rope.line_to_byte(1), 7);
+    EXPECT_EQ(rope.line_to_byte(2), 13);
+    EXPECT_EQ(rope.byte_to_line(12), 1);
+    EXPECT_EQ(rope.byte_to_line(13), 2);
+
+    EXPECT_TRUE(rope.is_char_boundary(3));
+    EXPECT_FALSE(rope.is_char_boundary(4));
+}
+
+TEST(RopeTest, Iterators)
+{
+    using namespace literal;
+
+    auto rope = Rope::from("Hello\r\nWörld\n\nfoo"_s);
+
+    auto lines = rope.lines() | std::ranges::to<std::vector<Cow<>>>();
+    ASSERT_EQ(lines.size(), 4);
+    EXPECT_EQ(lines[0], "Hello"_s);
+    EXPECT_EQ(lines[1], "Wörld"_s);
+    EXPECT_EQ(lines[2], ""_s);
+    EXPECT_EQ(lines[3], "foo"_s);
+
+    auto chars = std::vector<std::uint32_t>();
+    for (const auto& ch : Rope::from("aö\U0001F600"_s).chars())
+    {
+        chars.push_back(ch.code_point());
+    }
+    EXPECT_EQ(chars, (std::vector<std::uint32_t>{'a', 0xF6, 0x1F600}));
+
+    auto slice = rope.slice(7, 13);
+    EXPECT_EQ(slice, "Wörld"_s);
+    EXPECT_TRUE(slice.to_cow().is_borrowed());
+    EXPECT_EQ(slice.to_string(), "Wörld"_s);
+
+    size_t total = 0;
+    for (const auto& chunk : rope.chunks())
+    {
+        total += chunk.size();
+    }
+    EXPECT_EQ(total, rope.size());
+}
+
+#endif
@@ -144,6 +144,25 @@ TEST(StringTest, StrSlicing)
     // Test invalid slice
     EXPECT_DEATH(hello_world.slice(0, 20), ".*");
     EXPECT_DEATH(hello_world.slice(20), ".*");
+    EXPECT_DEATH(hello_world.slice(5, 0), ".*");
+
+    // Test char boundaries
+    auto unicode = "你好，世界"_s;
+    EXPECT_EQ(unicode.is_char_boundary(0), true);
+    EXPECT_EQ(unicode.is_char_boundary(3), true);
+    EXPECT_EQ(unicode.is_char_boundary(4), false);
+    EXPECT_EQ(unicode.is_char_boundary(unicode.size()), true);
+    EXPECT_EQ(unicode.is_char_boundary(unicode.size() + 1), false);
+    EXPECT_EQ(unicode.slice(9, 15), "世界");
+    EXPECT_DEATH(unicode.slice(1, 6), ".*");
+    EXPECT_DEATH(unicode.slice(0, 7), ".*");
+
+    // Test get and slice_unchecked
+    EXPECT_EQ(unicode.get(0, 6).unwrap(), "你好");
+    EXPECT_EQ(unicode.get(0, 5).is_none(), true);
+    EXPECT_EQ(unicode.get(6, 3).is_none(), true);
+    EXPECT_EQ(unicode.get(0, 100).is_none(), true);
+    EXPECT_EQ(unicode.slice_unchecked(6, 9), "，");
 }
 
 TEST(StringTest, StrTrim)
@@ -194,9 +213,9 @@ TEST(StringTest, StrSplit)
         // Test split
         auto split = hello_world.split(space);
         auto it = split.begin();
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), hello);
+        EXPECT_EQ(*it, hello);
         ++it;
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), world);
+        EXPECT_EQ(*it, world);
         ++it;
         EXPECT_EQ(it, split.end());
     }
@@ -207,7 +226,7 @@ TEST(StringTest, StrSplit)
         // Test split
         auto split = hello_world.split("");
         auto it = split.begin();
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), hello_world);
+        EXPECT_EQ(*it, hello_world);
         ++it;
         EXPECT_EQ(it, split.end());
     }
@@ -218,13 +237,13 @@ TEST(StringTest, StrSplit)
         // Test split
         auto split = hello_world.split(space);
         auto it = split.begin();
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), "");
+        EXPECT_EQ(*it, "");
         ++it;
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), hello);
+        EXPECT_EQ(*it, hello);
         ++it;
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), world);
+        EXPECT_EQ(*it, world);
         ++it;
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), "");
+        EXPECT_EQ(*it, "");
         ++it;
         EXPECT_EQ(it, split.end());
     }
@@ -234,14 +253,235 @@ TEST(StringTest, StrSplit)
         auto str_with_ws = "  Hello   World  "_s;
         auto split_ws = str_with_ws.split_ascii_whitespace();
         auto it2 = split_ws.begin();
-        EXPECT_EQ(str::from_bytes_unchecked(it2->data, it2->len), hello);
+        EXPECT_EQ(*it2, hello);
         ++it2;
-        EXPECT_EQ(str::from_bytes_unchecked(it2->data, it2->len), world);
+        EXPECT_EQ(*it2, world);
         ++it2;
         EXPECT_EQ(it2, split_ws.end());
     }
 }
 
+TEST(StringTest, StrSplitOnce)
+{
+    using namespace literal;
+
+    const auto collect = [](auto&& pieces)
+    {
+        auto result = std::vector<str>();
+        for (const auto& piece : pieces)
+        {
+            result.push_back(piece);
+        }
+
+        return result;
+    };
+
+    {
+        // Test split_once and rsplit_once
+        auto kv = "key=value=more"_s;
+        EXPECT_EQ(kv.split_once("=").unwrap(), std::pair("key"_s, "value=more"_s));
+        EXPECT_EQ(kv.rsplit_once("=").unwrap(), std::pair("key=value"_s, "more"_s));
+        EXPECT_EQ(kv.split_once("==").is_none(), true);
+        EXPECT_EQ(kv.rsplit_once("").is_none(), true);
+        EXPECT_EQ("你好，世界"_s.split_once("，").unwrap(), std::pair("你好"_s, "世界"_s));
+    }
+
+    {
+        // Test splitn and rsplitn
+        auto path = "a/b/c/d"_s;
+        EXPECT_EQ(collect(path.splitn(0, "/")), std::vector<str>());
+        EXPECT_EQ(collect(path.splitn(1, "/")), std::vector{"a/b/c/d"_s});
+        EXPECT_EQ(collect(path.splitn(2, "/")), (std::vector{"a"_s, "b/c/d"_s}));
+        EXPECT_EQ(collect(path.splitn(10, "/")), (std::vector{"a"_s, "b"_s, "c"_s, "d"_s}));
+        EXPECT_EQ(collect(path.rsplitn(2, "/")), (std::vector{"d"_s, "a/b/c"_s}));
+        EXPECT_EQ(collect("aXXbXXc"_s.rsplitn(5, "XX")), (std::vector{"c"_s, "b"_s, "a"_s}));
+        EXPECT_EQ(collect(""_s.splitn(3, ",")), std::vector{""_s});
+    }
+
+    {
+        // Test split_terminator
+        EXPECT_EQ(collect("A.B."_s.split_terminator(".")), (std::vector{"A"_s, "B"_s}));
+        EXPECT_EQ(collect("A..B.."_s.split_terminator(".")), (std::vector{"A"_s, ""_s, "B"_s, ""_s}));
+        EXPECT_EQ(collect("A.B"_s.split_terminator(".")), (std::vector{"A"_s, "B"_s}));
+        EXPECT_EQ(collect("."_s.split_terminator(".")), std::vector{""_s});
+        EXPECT_EQ(collect(""_s.split_terminator(".")), std::vector<str>());
+    }
+
+    {
+        // Test split_inclusive
+        EXPECT_EQ(collect("line1\nline2\n"_s.split_inclusive("\n")), (std::vector{"line1\n"_s, "line2\n"_s}));
+        EXPECT_EQ(collect("line1\nline2"_s.split_inclusive("\n")), (std::vector{"line1\n"_s, "line2"_s}));
+        EXPECT_EQ(collect("\n\n"_s.split_inclusive("\n")), (std::vector{"\n"_s, "\n"_s}));
+        EXPECT_EQ(collect(""_s.split_inclusive("\n")), std::vector<str>());
+    }
+}
+
+TEST(StringTest, StrCharPattern)
+{
+    using namespace literal;
+
+    const auto collect = [](auto&& pieces)
+    {
+        auto result = std::vector<str>();
+        for (const auto& piece : pieces)
+        {
+            result.push_back(piece);
+        }
+
+        return result;
+    };
+
+    auto s = "a,b;c d"_s;
+    auto unicode = "你好，世界。"_s;
+
+    {
+        // Test char and Char patterns
+        EXPECT_EQ(s.find(',').unwrap(), 1);
+        EXPECT_EQ(s.rfind(' ').unwrap(), 5);
+        EXPECT_EQ(s.find('x').is_none(), true);
+        EXPECT_EQ(s.contains(';'), true);
+        EXPECT_EQ(s.starts_with('a'), true);
+        EXPECT_EQ(s.ends_with('d'), true);
+        EXPECT_EQ(unicode.find(Char(0xFF0C)).unwrap(), 6);
+        EXPECT_EQ(unicode.ends_with(Char(0x3002)), true);
+        EXPECT_EQ(collect(unicode.split(Char(0xFF0C))), (std::vector{"你好"_s, "世界。"_s}));
+    }
+
+    {
+        // Test char sets
+        const auto separators = std::array{',', ';', ' '};
+        EXPECT_EQ(collect(s.split(separators)), (std::vector{"a"_s, "b"_s, "c"_s, "d"_s}));
+        auto positions = std::vector<size_t>();
+        for (const auto pos : s.matches(separators))
+        {
+            positions.push_back(pos);
+        }
+        EXPECT_EQ(positions, (std::vector<size_t>{1, 3, 5}));
+        EXPECT_EQ(s.rfind(separators).unwrap(), 5);
+        EXPECT_EQ(collect(unicode.split(std::array{Char(0xFF0C), Char(0x3002)})), (std::vector{"你好"_s, "世界"_s}));
+        EXPECT_EQ("\t  hello \t"_s.trim_start_matches(std::array{' ', '\t'}), "hello \t");
+        EXPECT_EQ("\t  hello \t"_s.trim_end_matches(std::array{' ', '\t'}), "\t  hello");
+    }
+
+    {
+        // Test predicates
+        EXPECT_EQ("123abc456"_s.trim_start_matches(&Char::is_ascii_digit), "abc456");
+        EXPECT_EQ("123abc456"_s.trim_end_matches(&Char::is_ascii_digit), "123abc");
+        EXPECT_EQ("abc1"_s.find(&Char::is_ascii_digit).unwrap(), 3);
+        EXPECT_EQ(unicode.find([](Char ch) { return !ch.is_ascii(); }).unwrap(), 0);
+        EXPECT_EQ("ab"_s.contains([](Char ch) { return ch.is_ascii_uppercase(); }), false);
+        EXPECT_EQ(collect("a1b22c"_s.split(&Char::is_ascii_digit)), (std::vector{"a"_s, "b"_s, ""_s, "c"_s}));
+    }
+
+    {
+        // Test iterators outliving their view, they hold the pattern themselves
+        const auto sep = ' ';
+        auto it = s.split([sep](Char ch) { return ch == Char(sep); }).begin();
+        EXPECT_EQ(*it, "a,b;c"_s);
+        ++it;
+        EXPECT_EQ(*it, "d"_s);
+
+        auto pos = s.matches(';').begin();
+        EXPECT_EQ(*pos, 3);
+    }
+}
+
+TEST(StringTest, StrFinder)
+{
+    using namespace literal;
+
+    const auto finder = Finder(", "_s);
+    const auto finder_rev = FinderRev(", "_s);
+    auto s = "a, b, c"_s;
+
+    EXPECT_EQ(finder.needle(), ", ");
+    EXPECT_EQ(s.find(finder).unwrap(), 1);
+    EXPECT_EQ(s.rfind(finder_rev).unwrap(), 4);
+    EXPECT_EQ(finder.find_at(s, 2).unwrap(), 4);
+    EXPECT_EQ("abc"_s.find(finder).is_none(), true);
+    EXPECT_EQ("abc"_s.rfind(finder_rev).is_none(), true);
+    EXPECT_EQ(s.replace(finder, " | "_s), "a | b | c"_s);
+
+    auto positions = std::vector<size_t>();
+    for (const auto pos : s.matches(finder))
+    {
+        positions.push_back(pos);
+    }
+    EXPECT_EQ(positions, (std::vector<size_t>{1, 4}));
+
+    auto parts = std::vector<str>();
+    for (const auto& part : s.split(finder))
+    {
+        parts.push_back(part);
+    }
+    EXPECT_EQ(parts, (std::vector{"a"_s, "b"_s, "c"_s}));
+
+    // Periodic needles exercise the memory of the Two-Way algorithm
+    const auto periodic = Finder("abab"_s);
+    EXPECT_EQ("abaabababab"_s.find(periodic).unwrap(), 3);
+    EXPECT_EQ("你好世界你好"_s.rfind(FinderRev("你好"_s)).unwrap(), 12);
+
+    // The finder can be shared across threads
+    auto results = std::vector<size_t>(4);
+    {
+        auto threads = std::vector<std::jthread>();
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            threads.emplace_back([&, i] { results[i] = s.find(finder).unwrap(); });
+        }
+    }
+    EXPECT_EQ(results, (std::vector<size_t>{1, 1, 1, 1}));
+}
+
+TEST(StringTest, StrCharClass)
+{
+    using namespace literal;
+
+    const auto separators = CharClass(",;\t"_s);
+    const auto blanks = CharClass(" \t"_s);
+    const auto cjk_punctuation = CharClass("，。"_s);
+
+    EXPECT_EQ(separators.is_ascii(), true);
+    EXPECT_EQ(cjk_punctuation.is_ascii(), false);
+    EXPECT_EQ(cjk_punctuation.contains(Char(0x3002)), true);
+    EXPECT_EQ(cjk_punctuation.contains(Char(0x3001)), false);
+
+    {
+        // Test find_any_of and find_not_of
+        auto s = "key\tvalue;other"_s;
+        EXPECT_EQ(s.find_any_of(separators).unwrap(), 3);
+        EXPECT_EQ(s.find_not_of(CharClass("aeky"_s)).unwrap(), 3);
+        EXPECT_EQ("abc"_s.find_any_of(separators).is_none(), true);
+        EXPECT_EQ("  \t"_s.find_not_of(blanks).is_none(), true);
+        EXPECT_EQ("你好，世界"_s.find_any_of(cjk_punctuation).unwrap(), 6);
+        EXPECT_EQ("，。好"_s.find_not_of(cjk_punctuation).unwrap(), 6);
+    }
+
+    {
+        // Test trim_matches
+        EXPECT_EQ(" \t hello world\t "_s.trim_matches(blanks), "hello world");
+        EXPECT_EQ("。。你好。"_s.trim_matches(cjk_punctuation), "你好");
+        EXPECT_EQ(" \t "_s.trim_matches(blanks), "");
+    }
+
+    {
+        // Test split_any
+        auto parts = std::vector<str>();
+        for (const auto& part : "a,b;;c\td"_s.split_any(separators))
+        {
+            parts.push_back(part);
+        }
+        EXPECT_EQ(parts, (std::vector{"a"_s, "b"_s, ""_s, "c"_s, "d"_s}));
+
+        parts.clear();
+        for (const auto& part : "你好，世界。"_s.split_any(cjk_punctuation))
+        {
+            parts.push_back(part);
+        }
+        EXPECT_EQ(parts, (std::vector{"你好"_s, "世界"_s}));
+    }
+}
+
 TEST(StringTest, StrLines)
 {
     using namespace literal;
@@ -255,9 +495,9 @@ TEST(StringTest, StrLines)
         auto lines = multi_line.lines();
         auto it = lines.begin();
 
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), hello);
+        EXPECT_EQ(*it, hello);
         ++it;
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), world);
+        EXPECT_EQ(*it, world);
         ++it;
         EXPECT_EQ(it, lines.end());
     }
@@ -268,9 +508,9 @@ TEST(StringTest, StrLines)
         auto lines = multi_line.lines();
         auto it = lines.begin();
 
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), hello);
+        EXPECT_EQ(*it, hello);
         ++it;
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), world);
+        EXPECT_EQ(*it, world);
         ++it;
         EXPECT_EQ(it, lines.end());
     }
@@ -281,9 +521,9 @@ TEST(StringTest, StrLines)
         auto lines = multi_line.lines();
         auto it = lines.begin();
 
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), hello);
+        EXPECT_EQ(*it, hello);
         ++it;
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), world);
+        EXPECT_EQ(*it, world);
         ++it;
         EXPECT_EQ(it, lines.end());
     }
@@ -295,16 +535,58 @@ TEST(StringTest, StrLines)
         auto lines = multi_line.lines();
         auto it = lines.begin();
 
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), empty);
+        EXPECT_EQ(*it, empty);
         ++it;
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), empty);
+        EXPECT_EQ(*it, empty);
         ++it;
-        EXPECT_EQ(str::from_bytes_unchecked(it->data, it->len), empty);
+        EXPECT_EQ(*it, empty);
         ++it;
         EXPECT_EQ(it, lines.end());
     }
 }
 
+TEST(StringTest, StrIterRemainder)
+{
+    using namespace literal;
+
+    static_assert(std::ranges::borrowed_range<decltype(std::declval<const str&>().lines())>);
+    static_assert(std::ranges::borrowed_range<decltype(std::declval<const str&>().split(std::declval<const str&>()))>);
+    static_assert(std::ranges::borrowed_range<decltype(std::declval<const str&>().split_ascii_whitespace())>);
+
+    {
+        const auto s = "key=value;name=crab;rest"_s;
+        auto it = std::ranges::begin(s.split(";"_s));
+
+        EXPECT_EQ(*it, "key=value"_s);
+        EXPECT_EQ(it.position(), 0);
+        EXPECT_EQ(it.remainder(), s);
+        ++it;
+        EXPECT_EQ(*it, "name=crab"_s);
+        EXPECT_EQ(it.position(), 10);
+        EXPECT_EQ(it.remainder(), "name=crab;rest"_s);
+    }
+
+    {
+        const auto s = "first\r\nsecond\nthird"_s;
+        auto it = std::ranges::begin(s.lines());
+        ++it;
+
+        EXPECT_EQ(*it, "second"_s);
+        EXPECT_EQ(it.position(), 7);
+        EXPECT_EQ(it.remainder(), "second\nthird"_s);
+    }
+
+    {
+        const auto s = "  Hello   World  "_s;
+        auto it = std::ranges::begin(s.split_ascii_whitespace());
+        ++it;
+
+        EXPECT_EQ(*it, "World"_s);
+        EXPECT_EQ(it.position(), 10);
+        EXPECT_EQ(it.remainder(), "World  "_s);
+    }
+}
+
 TEST(StringTest, StrChars)
 {
     using namespace literal;
@@ -320,6 +602,67 @@ TEST(StringTest, StrChars)
     EXPECT_EQ(it, chars.end());
 }
 
+TEST(StringTest, StrViews)
+{
+    using namespace literal;
+
+    using Chars = decltype(std::declval<const str&>().chars());
+    using Graphemes = decltype(std::declval<const str&>().graphemes());
+    using Matches = decltype(std::declval<const str&>().matches(std::declval<const str&>()));
+
+    static_assert(std::ranges::view<Chars> && std::ranges::borrowed_range<Chars>);
+    static_assert(std::ranges::view<Graphemes> && std::ranges::borrowed_range<Graphemes>);
+    static_assert(std::ranges::view<Matches> && std::ranges::borrowed_range<Matches>);
+
+    using CharSplit = decltype(std::declval<const str&>().split(' '));
+    using CharMatches = decltype(std::declval<const str&>().matches(&Char::is_ascii_digit));
+    using SplitAny = decltype(std::declval<const str&>().split_any(std::declval<const CharClass&>()));
+    using SplitN = decltype(std::declval<const str&>().splitn(2, std::declval<const str&>()));
+    using RSplitN = decltype(std::declval<const str&>().rsplitn(2, std::declval<const str&>()));
+    using SplitTerminator = decltype(std::declval<const str&>().split_terminator(std::declval<const str&>()));
+    using SplitInclusive = decltype(std::declval<const str&>().split_inclusive(std::declval<const str&>()));
+    using FinderMatches = decltype(std::declval<const str&>().matches(std::declval<const Finder&>()));
+    using FinderSplit = decltype(std::declval<const str&>().split(std::declval<const Finder&>()));
+
+    static_assert(std::ranges::view<CharSplit> && std::ranges::borrowed_range<CharSplit>);
+    static_assert(std::ranges::view<CharMatches> && std::ranges::borrowed_range<CharMatches>);
+    static_assert(std::ranges::view<SplitAny> && std::ranges::borrowed_range<SplitAny>);
+    static_assert(std::ranges::view<SplitN> && std::ranges::borrowed_range<SplitN>);
+    static_assert(std::ranges::view<RSplitN> && std::ranges::borrowed_range<RSplitN>);
+    static_assert(std::ranges::view<SplitTerminator> && std::ranges::borrowed_range<SplitTerminator>);
+    static_assert(std::ranges::view<SplitInclusive> && std::ranges::borrowed_range<SplitInclusive>);
+    static_assert(std::ranges::view<FinderMatches> && std::ranges::borrowed_range<FinderMatches>);
+    static_assert(std::ranges::view<FinderSplit> && std::ranges::borrowed_range<FinderSplit>);
+
+    // The views hold the bytes, so iterating a view of a temporary str is fine
+    auto code_points = std::vector<std::uint32_t>();
+    for (const auto ch : "aö\U0001F600"_s.chars())
+    {
+        code_points.push_back(ch.code_point());
+    }
+    EXPECT_EQ(code_points, (std::vector<std::uint32_t>{'a', 0xF6, 0x1F600}));
+
+    auto graphemes = std::vector<str>();
+    for (const auto grapheme : "e\u0301a"_s.graphemes())
+    {
+        graphemes.push_back(grapheme);
+    }
+    EXPECT_EQ(graphemes, (std::vector{"e\u0301"_s, "a"_s}));
+
+    auto positions = std::vector<size_t>();
+    for (const auto pos : "abcabca"_s.matches("a"_s))
+    {
+        positions.push_back(pos);
+    }
+    EXPECT_EQ(positions, (std::vector<size_t>{0, 3, 6}));
+
+    // Borrowed ranges give iterators, not std::ranges::dangling, for temporary views
+    const auto text = "a b c"_s;
+    const auto it = std::ranges::next(std::ranges::begin(text.split(' ')));
+    EXPECT_EQ(*it, "b"_s);
+    EXPECT_EQ(*std::ranges::find(text.splitn(2, " "_s), "b c"_s), "b c"_s);
+}
+
 TEST(StringTest, StrParse)
 {
     using namespace literal;
@@ -377,6 +720,27 @@ TEST(StringTest, StrParse)
     auto partial_result = partial_str.parse<int32_t>();
     EXPECT_TRUE(partial_result.is_err());
     EXPECT_EQ(partial_result.unwrap_err().ec, std::errc::invalid_argument);
+
+    // Test long integers, parsed 8 digits at a time
+    EXPECT_EQ("1234567890123456789"_s.parse<int64_t>().unwrap(), 1234567890123456789);
+    EXPECT_EQ("-9223372036854775808"_s.parse<int64_t>().unwrap(), std::numeric_limits<int64_t>::min());
+    EXPECT_EQ("000000000000000000018446744073709551615"_s.parse<uint64_t>().unwrap(), std::numeric_limits<uint64_t>::max());
+    EXPECT_EQ("18446744073709551616"_s.parse<uint64_t>().unwrap_err().ec, std::errc::result_out_of_range);
+    EXPECT_EQ("-1"_s.parse<uint32_t>().unwrap_err().ec, std::errc::invalid_argument);
+    EXPECT_EQ("-"_s.parse<int32_t>().unwrap_err().ec, std::errc::invalid_argument);
+    EXPECT_EQ("12345678x"_s.parse<int32_t>().unwrap_err().ec, std::errc::invalid_argument);
+
+    // Test parse_all
+    auto column = "1,22,333,4444"_s;
+    auto all_result = strings::parse_all<int32_t>(column.split(","));
+    EXPECT_TRUE(all_result.is_ok());
+    EXPECT_EQ(all_result.unwrap(), (std::vector<int32_t>{1, 22, 333, 4444}));
+
+    auto invalid_column = "1.5,2.5,x,4"_s;
+    auto invalid_all_result = strings::parse_all<double>(invalid_column.split(","));
+    EXPECT_TRUE(invalid_all_result.is_err());
+    EXPECT_EQ(invalid_all_result.unwrap_err().index, 2);
+    EXPECT_EQ(invalid_all_result.unwrap_err().ec, std::errc::invalid_argument);
 }
 
 TEST(StringTest, StrAsciiCase)
@@ -407,6 +771,64 @@ TEST(StringTest, StrAsciiCase)
     EXPECT_EQ(empty_str.to_ascii_uppercase(), empty_str);
 }
 
+TEST(StringTest, StrUnicodeCase)
+{
+    using namespace literal;
+
+    // Test to_lowercase and to_uppercase
+    EXPECT_EQ("HÉLLÖ Wörld"_s.to_lowercase(), "héllö wörld"_s);
+    EXPECT_EQ("héllö wörld"_s.to_uppercase(), "HÉLLÖ WÖRLD"_s);
+    EXPECT_EQ("ΑΒΓ"_s.to_lowercase(), "αβγ"_s);
+    EXPECT_EQ(""_s.to_lowercase(), ""_s);
+
+    // Test case_fold
+    EXPECT_EQ("Straße"_s.case_fold(), "strasse"_s);
+    EXPECT_EQ("HELLO"_s.case_fold(), "hello"_s);
+
+    // Test eq_ignore_case
+    EXPECT_TRUE("RésumÉ"_s.eq_ignore_case("rÉsumé"_s));
+    EXPECT_TRUE("STRASSE"_s.eq_ignore_case("straße"_s));
+    EXPECT_TRUE("The quick brown fox jumps over the lazy dog"_s.eq_ignore_case("THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG"_s));
+    EXPECT_TRUE("\u212A"_s.eq_ignore_case("k"_s)); // KELVIN SIGN
+    EXPECT_FALSE("hello"_s.eq_ignore_case("hellO!"_s));
+    EXPECT_FALSE("[\\]"_s.eq_ignore_case("{|}"_s));
+    EXPECT_TRUE(""_s.eq_ignore_case(""_s));
+}
+
+TEST(StringTest, StrNormalize)
+{
+    using namespace literal;
+
+    auto composed = "caf\u00E9"_s;
+    auto decomposed = "cafe\u0301"_s;
+
+    // Test is_normalized
+    EXPECT_TRUE("hello"_s.is_normalized<NormalizationForm::NFC>());
+    EXPECT_TRUE(composed.is_normalized<NormalizationForm::NFC>());
+    EXPECT_FALSE(decomposed.is_normalized<NormalizationForm::NFC>());
+    EXPECT_TRUE(decomposed.is_normalized<NormalizationForm::NFD>());
+    EXPECT_FALSE(composed.is_normalized<NormalizationForm::NFD>());
+    EXPECT_FALSE("\uFB01"_s.is_normalized<NormalizationForm::NFKC>()); // LATIN SMALL LIGATURE FI
+    EXPECT_FALSE("\u212B"_s.is_normalized<NormalizationForm::NFC>()); // ANGSTROM SIGN
+
+    // Test normalize
+    EXPECT_EQ(decomposed.normalize<NormalizationForm::NFC>(), composed);
+    EXPECT_EQ(composed.normalize<NormalizationForm::NFD>(), decomposed);
+    EXPECT_EQ(composed.normalize<NormalizationForm::NFC>(), composed);
+    EXPECT_EQ("\uFB01"_s.normalize<NormalizationForm::NFKC>(), "fi"_s);
+    EXPECT_EQ("\uFB01"_s.normalize<NormalizationForm::NFKD>(), "fi"_s);
+    EXPECT_EQ("\uAC00"_s.normalize<NormalizationForm::NFD>(), "\u1100\u1161"_s);
+
+    // Test normalize_cow
+    auto borrowed = composed.normalize_cow<NormalizationForm::NFC>();
+    EXPECT_TRUE(borrowed.is_borrowed());
+    EXPECT_EQ(borrowed.as_str().data(), composed.data());
+
+    auto owned = decomposed.normalize_cow<NormalizationForm::NFC>();
+    EXPECT_TRUE(owned.is_owned());
+    EXPECT_EQ(owned.as_str(), composed);
+}
+
 TEST(StringTest, StrToStdString)
 {
     using namespace literal;
@@ -424,6 +846,33 @@ TEST(StringTest, StrToStdString)
     EXPECT_EQ(empty_std.size(), 0);
 }
 
+TEST(StringTest, StrFormat)
+{
+    using namespace literal;
+
+    // Test a slice that is not null-terminated
+    auto hello_world = "Hello World"_s;
+    auto hello = hello_world.slice(0, 5);
+    EXPECT_EQ(std::format("{}", hello), "Hello");
+    EXPECT_EQ(std::format("[{:>7}]", hello), "[  Hello]");
+    EXPECT_EQ(std::format("[{:*<7}]", hello), "[Hello**]");
+    EXPECT_EQ(std::format("[{:.3}]", hello), "[Hel]");
+
+    // Test width and precision measured in characters, not bytes
+    EXPECT_EQ(std::format("[{:>7}]", "h\u00E9llo"_s), "[  h\u00E9llo]");
+    EXPECT_EQ(std::format("[{:.2}]", "h\u00E9llo"_s), "[h\u00E9]");
+    EXPECT_EQ(std::format("[{:^8}]", "\u4E16\u754C"_s), "[  \u4E16\u754C  ]");
+
+    // Test String and Cow
+    EXPECT_EQ(std::format("[{:>6}]", String::from("abc").unwrap()), "[   abc]");
+    EXPECT_EQ(std::format("[{:<4}]", Cow<>(hello)), "[Hello]");
+
+    // Test operator<<
+    std::ostringstream os;
+    os << hello << '|' << std::setw(7) << hello;
+    EXPECT_EQ(os.str(), "Hello|  Hello");
+}
+
 TEST(StringTest, StrReplace)
 {
     using namespace literal;
@@ -473,6 +922,44 @@ TEST(StringTest, StrReplace)
     EXPECT_EQ(hello_world.replace_n(space, empty_replacement, 1), "HelloWorld"_s);
 }
 
+TEST(StringTest, StrCow)
+{
+    using namespace literal;
+
+    auto hello_world = "Hello World"_s;
+
+    // Test replace_cow borrows when nothing matches
+    auto unchanged = hello_world.replace_cow("xyz"_s, "abc"_s);
+    EXPECT_TRUE(unchanged.is_borrowed());
+    EXPECT_EQ(unchanged->data(), hello_world.data());
+    EXPECT_EQ(unchanged, hello_world);
+
+    auto replaced = hello_world.replace_cow("World"_s, "Universe"_s);
+    EXPECT_TRUE(replaced.is_owned());
+    EXPECT_EQ(replaced, "Hello Universe"_s);
+
+    EXPECT_TRUE("aaa"_s.replace_n_cow("a"_s, "b"_s, 0).is_borrowed());
+    EXPECT_EQ("aaa"_s.replace_n_cow("a"_s, "b"_s, 2), "bba"_s);
+    EXPECT_EQ("xxaxa"_s.replace_n_cow("a"_s, "b"_s, 1), "xxbxa"_s);
+    EXPECT_EQ("xxaxa"_s.replace_cow("a"_s, "bc"_s), "xxbcxbc"_s);
+
+    // Test case conversions
+    EXPECT_TRUE("hello world 123"_s.to_ascii_lowercase_cow().is_borrowed());
+    EXPECT_EQ(hello_world.to_ascii_lowercase_cow(), "hello world"_s);
+    EXPECT_TRUE("HELLO WORLD"_s.to_ascii_uppercase_cow().is_borrowed());
+    EXPECT_EQ(hello_world.to_ascii_uppercase_cow(), "HELLO WORLD"_s);
+    EXPECT_TRUE("héllö wörld"_s.to_lowercase_cow().is_borrowed());
+    EXPECT_EQ("héllö wörld, HÉLLÖ"_s.to_lowercase_cow(), "héllö wörld, héllö"_s);
+    EXPECT_EQ("straße"_s.to_uppercase_cow(), "STRAßE"_s);
+    EXPECT_EQ("straße"_s.case_fold_cow(), "strasse"_s);
+
+    // Test into_owned and to_mut
+    auto cow = "hello"_s.to_ascii_lowercase_cow();
+    cow.to_mut().push_str(" world"_s);
+    EXPECT_TRUE(cow.is_owned());
+    EXPECT_EQ(std::move(cow).into_owned(), "hello world"_s);
+}
+
 TEST(StringTest, StrRepeat)
 {
     using namespace literal;
@@ -498,6 +985,32 @@ TEST(StringTest, JoinWith)
     EXPECT_EQ(s.split(",") | strings::join_with(".") | std::ranges::to<String>(), "hello.world"_s);
 }
 
+TEST(StringTest, JoinConcat)
+{
+    using namespace literal;
+
+    auto s = "hello,world,again"_s;
+    EXPECT_EQ(strings::join(s.split(","), "."), "hello.world.again"_s);
+    EXPECT_EQ(strings::join(s.split(","), ", "_s), "hello, world, again"_s);
+    EXPECT_EQ(strings::join(std::vector{"你好"_s}, "-"), "你好"_s);
+    EXPECT_EQ(strings::join(std::vector<str>(), "-"), ""_s);
+    EXPECT_EQ(strings::join(std::vector{""_s, ""_s}, "-").size(), 1);
+
+    EXPECT_EQ(strings::concat("foo"_s, "-"_s, "bar"_s), "foo-bar"_s);
+    EXPECT_EQ(strings::concat().size(), 0);
+
+    // concat_in builds the String with the given allocator
+    auto buffer = std::array<std::byte, 256>();
+    auto resource = std::pmr::monotonic_buffer_resource(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    const auto in_buffer = strings::concat_in(std::pmr::polymorphic_allocator<std::byte>(&resource), "foo"_s, "-"_s, "bar"_s);
+    EXPECT_EQ(in_buffer, "foo-bar"_s);
+    EXPECT_TRUE(in_buffer.data() >= buffer.data() && in_buffer.data() < buffer.data() + buffer.size());
+
+    const auto joined = strings::join(s.split(","), "");
+    EXPECT_EQ(joined, "helloworldagain"_s);
+    EXPECT_GE(joined.capacity(), joined.size());
+}
+
 TEST(StringTest, StrMatches)
 {
     using namespace literal;
@@ -614,4 +1127,29 @@ TEST(StringTest, TrimEndMatches)
     EXPECT_EQ(short_text.trim_end_matches(long_pattern), short_text);
 }
 
+TEST(StringTest, EncodeUtf16)
+{
+    using namespace literal;
+
+    const auto s = "Hello, 世界 🦀"_s;
+    const auto expected = std::u16string(u"Hello, 世界 🦀");
+
+    auto units = std::u16string();
+    for (const auto unit : s.encode_utf16())
+    {
+        units.push_back(unit);
+    }
+    EXPECT_EQ(units, expected);
+    EXPECT_EQ(s.utf16_len(), expected.size());
+    EXPECT_EQ(std::ranges::distance(s.encode_utf16()), std::ssize(expected));
+
+    // to_utf16 appends
+    auto out = std::u16string(u">");
+    s.to_utf16(out);
+    EXPECT_EQ(out, u">" + expected);
+
+    EXPECT_EQ(""_s.utf16_len(), 0);
+    EXPECT_TRUE(std::ranges::empty(""_s.encode_utf16()));
+}
+
 #endif
\ No newline at end of file
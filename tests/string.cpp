@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 
 import crab_cpp;
+import std;
 
 using namespace crab_cpp;
 
@@ -64,6 +65,38 @@ TEST(StringTest, From)
     EXPECT_TRUE(result.is_err());
 }
 
+TEST(StringTest, FromByteRange)
+{
+    using namespace literal;
+
+    const auto hello = "héllo"_s;
+    const auto bytes = std::vector<std::byte>(hello.as_bytes().begin(), hello.as_bytes().end());
+
+    // Contiguous sized ranges
+    auto s = String(bytes);
+    EXPECT_EQ(s, hello);
+    EXPECT_EQ(std::strlen(s.c_str()), hello.size());
+    EXPECT_EQ(String(std::span(bytes)), hello);
+
+    // Sized ranges that are not contiguous
+    const auto deque = std::deque<std::byte>(bytes.begin(), bytes.end());
+    auto from_deque = String(deque);
+    EXPECT_EQ(from_deque, hello);
+    EXPECT_EQ(std::strlen(from_deque.c_str()), hello.size());
+    EXPECT_EQ(String::from_bytes_unchecked(deque), hello);
+
+    // Other views
+    auto filtered = String(bytes | std::views::filter([](std::byte b) { return b != std::byte{'l'}; }));
+    EXPECT_EQ(filtered, "héo"_s);
+    EXPECT_EQ(std::strlen(filtered.c_str()), filtered.size());
+
+    EXPECT_EQ(String::from_bytes_unchecked(bytes), hello);
+    EXPECT_TRUE(String(std::vector<std::byte>()).empty());
+
+    const auto invalid = std::vector<std::byte>{std::byte{0xC0}, std::byte{0x80}};
+    EXPECT_DEATH(String{invalid}, "Invalid UTF-8 sequence");
+}
+
 TEST(StringTest, CopyConstructor)
 {
     String s1 = String::from("hello").unwrap();
@@ -131,6 +164,46 @@ TEST(StringTest, Reserve)
     EXPECT_EQ(s, "hello"_s);
 }
 
+TEST(StringTest, ReserveGrowth)
+{
+    // Appending one char at a time reallocates a logarithmic number of times
+    String s;
+    auto expected = std::string();
+    size_t reallocations = 0;
+
+    for (size_t i = 0; i < 100000; i++)
+    {
+        const size_t capacity = s.capacity();
+        s.push(Char('a' + i % 26));
+        expected.push_back(char('a' + i % 26));
+        reallocations += s.capacity() != capacity ? 1 : 0;
+    }
+
+    EXPECT_LE(reallocations, 20);
+    EXPECT_GE(s.capacity(), s.size());
+    EXPECT_EQ(s, expected);
+    EXPECT_EQ(std::strlen(s.c_str()), 100000);
+
+    // So does calling reserve directly for small amounts
+    String r;
+    reallocations = 0;
+
+    for (size_t i = 0; i < 100000; i++)
+    {
+        const size_t capacity = r.capacity();
+        r.reserve(1);
+        r.push_str(str::from_raw_parts("x", 1).unwrap());
+        reallocations += r.capacity() != capacity ? 1 : 0;
+    }
+
+    EXPECT_LE(reallocations, 20);
+    EXPECT_EQ(r.size(), 100000);
+
+    // from_raw_parts null-terminates its buffer too
+    const auto t = String::from_raw_parts("hello world", 5).unwrap();
+    EXPECT_EQ(std::strlen(t.c_str()), 5);
+}
+
 TEST(StringTest, Clear)
 {
     String s = String::from("hello").unwrap();
@@ -167,6 +240,93 @@ TEST(StringTest, PushStr)
     EXPECT_EQ(s, "hello world"_s);
 }
 
+TEST(StringTest, PushNumbers)
+{
+    using namespace literal;
+
+    String s;
+    s.push_int(0);
+    s.push_str(","_s);
+    s.push_int(std::numeric_limits<int64_t>::min());
+    s.push_str(","_s);
+    s.push_int(std::numeric_limits<uint64_t>::max());
+    EXPECT_EQ(s, "0,-9223372036854775808,18446744073709551615"_s);
+    EXPECT_EQ(std::strlen(s.c_str()), s.size());
+
+    s.clear();
+    s.push_float(0.1);
+    s.push_str(","_s);
+    s.push_float(-1.7976931348623157e308);
+    s.push_str(","_s);
+    s.push_float(1.0f / 3.0f);
+    EXPECT_EQ(s, "0.1,-1.7976931348623157e+308,0.33333334"_s);
+
+    s.clear();
+    s.push_hex(0u);
+    s.push_str(","_s);
+    s.push_hex(0xDEADBEEFu);
+    s.push_str(","_s);
+    s.push_hex(0xDEADBEEFu, true);
+    s.push_str(","_s);
+    s.push_hex(int8_t(-1));
+    EXPECT_EQ(s, "0,deadbeef,DEADBEEF,ff"_s);
+
+    // Test many appends into a growing buffer
+    String numbers;
+    for (int32_t i = 0; i < 1000; i += 1)
+    {
+        numbers.push_int(i);
+    }
+    EXPECT_EQ(numbers.size(), 2890);
+    EXPECT_TRUE(numbers->ends_with("998999"_s));
+}
+
+TEST(StringTest, FormatTo)
+{
+    using namespace literal;
+
+    String s;
+    format_to(s, "{}-{:>4}-{}", 42, "ab", "héllo"_s);
+    EXPECT_EQ(s, "42-  ab-héllo"_s);
+    EXPECT_EQ(std::strlen(s.c_str()), s.size());
+
+    // Test output longer than the spare capacity
+    s.clear();
+    const auto long_text = std::string(1000, 'x');
+    format_to(s, "[{}]", long_text);
+    EXPECT_EQ(s.size(), 1002);
+    EXPECT_TRUE(s->starts_with("[xxx"_s));
+    EXPECT_TRUE(s->ends_with("xxx]"_s));
+
+    // Test the back insert iterator
+    String out;
+    std::format_to(out.back_inserter(), "{}+{}={}", 1, 2, 3);
+    EXPECT_EQ(out, "1+2=3"_s);
+
+    auto it = out.back_inserter();
+    it.reserve(64);
+    EXPECT_GE(out.capacity(), out.size() + 64);
+    it.append(" ok");
+    EXPECT_EQ(out, "1+2=3 ok"_s);
+
+    // Test empty output on strings that never allocated
+    String empty1;
+    format_to(empty1, "");
+    EXPECT_TRUE(empty1.empty());
+
+    String empty2;
+    format_to(empty2, "{}", "");
+    EXPECT_TRUE(empty2.empty());
+
+    String empty3;
+    empty3.back_inserter().append("");
+    EXPECT_TRUE(empty3.empty());
+
+    String empty4;
+    empty4.back_inserter().commit(0);
+    EXPECT_TRUE(empty4.empty());
+}
+
 TEST(StringTest, SplitOff)
 {
     using namespace literal;
@@ -180,6 +340,11 @@ TEST(StringTest, SplitOff)
 
     // Test invalid split position
     EXPECT_DEATH(s.split_off(10), ".*");
+
+    s = "你好，世界"_s;
+    EXPECT_EQ(s.split_off(9), "世界"_s);
+    EXPECT_EQ(s, "你好，"_s);
+    EXPECT_DEATH(s.split_off(1), ".*");
 }
 
 TEST(StringTest, Truncate)
@@ -296,4 +461,206 @@ TEST(StringTest, PlusOperator)
     EXPECT_EQ(s5, "hello!"_s);
 }
 
+TEST(StringTest, Utf8Validator)
+{
+    const char euro[] = "\xE2\x82\xAC";
+
+    // Test a sequence split across chunks
+    auto validator = Utf8Validator();
+    EXPECT_EQ(validator.feed(std::as_bytes(std::span(euro, 1))).unwrap(), 0);
+    EXPECT_FALSE(validator.is_complete());
+    EXPECT_EQ(validator.pending_len(), 1);
+    EXPECT_EQ(validator.feed(std::as_bytes(std::span(euro + 1, 2))).unwrap(), 3);
+    EXPECT_TRUE(validator.is_complete());
+    EXPECT_EQ(validator.finish().unwrap(), 3);
+
+    // Test error positions are absolute
+    const char invalid[] = "abc\xE2\x82\x41";
+    validator.reset();
+    EXPECT_TRUE(validator.feed(std::as_bytes(std::span(invalid, 4))).is_ok());
+    EXPECT_EQ(validator.feed(std::as_bytes(std::span(invalid + 4, 2))).unwrap_err().pos, 3);
+    EXPECT_EQ(validator.finish().unwrap_err().pos, 3);
+
+    // Test truncated input
+    validator.reset();
+    EXPECT_TRUE(validator.feed(std::as_bytes(std::span(euro, 2))).is_ok());
+    EXPECT_EQ(validator.finish().unwrap_err().pos, 0);
+
+    // Test surrogates and overlong encodings
+    const char surrogate[] = "\xED\xA0\x80";
+    EXPECT_FALSE(is_valid_utf8(surrogate, 3));
+    const char overlong[] = "\xE0\x80\xAF";
+    EXPECT_FALSE(is_valid_utf8(overlong, 3));
+}
+
+TEST(StringTest, Utf8Decoder)
+{
+    using namespace literal;
+
+    const char text[] = "h\xC3\xA9llo \xE4\xB8\x96\xE7\x95\x8C \xF0\x9F\x98\x80";
+    const size_t len = sizeof(text) - 1;
+
+    for (size_t chunk_size = 1; chunk_size <= len; chunk_size += 1)
+    {
+        auto decoder = Utf8Decoder();
+        for (size_t pos = 0; pos < len; pos += chunk_size)
+        {
+            EXPECT_TRUE(decoder.push(text + pos, std::min(chunk_size, len - pos)).is_ok());
+        }
+
+        EXPECT_EQ(std::move(decoder).finish().unwrap(), "héllo 世界 😀"_s);
+    }
+
+    auto decoder = Utf8Decoder();
+    EXPECT_TRUE(decoder.push(text, 2).is_ok());
+    EXPECT_TRUE(std::move(decoder).finish().is_err());
+
+    // Test chunks of several KB that split multi-byte chars, with and without reserving ahead
+    auto large = std::string();
+    while (large.size() < 64 * 1024)
+    {
+        large += "ab\xC3\xA9\xE4\xB8\x96\xF0\x9F\x98\x80";
+    }
+
+    for (const size_t chunk_size : std::array<size_t, 3>{4095, 4096, 5001})
+    {
+        for (const bool reserve : {false, true})
+        {
+            auto chunked = Utf8Decoder();
+            if (reserve)
+            {
+                chunked.reserve(chunk_size);
+            }
+
+            for (size_t pos = 0; pos < large.size(); pos += chunk_size)
+            {
+                EXPECT_TRUE(chunked.push(large.data() + pos, std::min(chunk_size, large.size() - pos)).is_ok());
+            }
+
+            const auto result = std::move(chunked).finish().unwrap();
+            EXPECT_EQ(result, large);
+            EXPECT_EQ(std::strlen(result.c_str()), large.size());
+        }
+    }
+}
+
+TEST(StringTest, SharedStr)
+{
+    using namespace literal;
+
+    static_assert(sizeof(ArcStr) == sizeof(str));
+    static_assert(sizeof(RcStr) == sizeof(str));
+
+    const auto arc = ArcStr("hello, 世界"_s);
+    EXPECT_EQ(arc, "hello, 世界"_s);
+    EXPECT_EQ(arc->find(",").unwrap(), 5);
+    EXPECT_EQ(std::strlen(arc.c_str()), arc.size());
+    EXPECT_EQ(arc.use_count(), 1);
+
+    {
+        auto consumers = std::vector<std::jthread>();
+        for (size_t i = 0; i < 4; i++)
+        {
+            consumers.emplace_back([copy = arc] { EXPECT_EQ(copy.as_str(), "hello, 世界"_s); });
+        }
+    }
+    EXPECT_EQ(arc.use_count(), 1);
+
+    auto copy = arc;
+    EXPECT_TRUE(copy.ptr_eq(arc));
+    EXPECT_EQ(arc.use_count(), 2);
+
+    auto moved = std::move(copy);
+    EXPECT_EQ(arc.use_count(), 2);
+    moved = ArcStr();
+    EXPECT_EQ(arc.use_count(), 1);
+
+    auto rc = RcStr(String::from("abc").unwrap());
+    auto rc2 = rc;
+    EXPECT_EQ(rc.use_count(), 2);
+    EXPECT_EQ(std::format("{}", rc2), "abc");
+
+    EXPECT_TRUE(RcStr().empty());
+    EXPECT_EQ(RcStr().use_count(), 0);
+    EXPECT_EQ(std::strlen(RcStr().c_str()), 0);
+}
+
+TEST(StringTest, InlineString)
+{
+    using namespace literal;
+
+    static_assert(std::is_trivially_copyable_v<InlineString<16>>);
+    static_assert(sizeof(InlineString<15>) == 17);
+
+    auto code = InlineString<8>::from("ab"_s).unwrap();
+    EXPECT_EQ(code, "ab"_s);
+    EXPECT_EQ(code->find("b").unwrap(), 1);
+    EXPECT_EQ(code.push(Char('c')).unwrap(), 3);
+    EXPECT_EQ(code.push_str("界"_s).unwrap(), 6);
+    EXPECT_EQ(std::strlen(code.c_str()), 6);
+
+    // A failed push leaves the string unchanged
+    const auto error = code.push_str("界"_s).unwrap_err();
+    EXPECT_EQ(error.required, 9);
+    EXPECT_EQ(error.capacity, 8);
+    EXPECT_EQ(code, "abc界"_s);
+
+    EXPECT_TRUE(InlineString<2>::from("abc"_s).is_err());
+
+    auto codes = std::array<InlineString<8>, 2>();
+    codes[1] = code;
+    EXPECT_EQ(std::format("{}", codes[1]), "abc界");
+    EXPECT_TRUE(codes[0].empty());
+
+    code.clear();
+    EXPECT_TRUE(code.empty());
+    EXPECT_EQ(std::strlen(code.c_str()), 0);
+}
+
+TEST(StringTest, Transcode)
+{
+    using namespace literal;
+
+    EXPECT_EQ(String::from_utf16(u"Hello, 世界 🦀").unwrap(), "Hello, 世界 🦀"_s);
+    EXPECT_EQ(String::from_utf16(u"").unwrap(), ""_s);
+
+    // An unpaired surrogate, either half of a pair
+    const auto units = std::u16string(u"ab\xD83E" u"c\xDD80");
+    EXPECT_EQ(String::from_utf16(units).unwrap_err().pos, 2);
+    EXPECT_EQ(String::from_utf16_lossy(units), "ab�c�"_s);
+
+    EXPECT_EQ(String::from_latin1("caf\xE9 \xA9 plain ascii text"), "café © plain ascii text"_s);
+
+    EXPECT_EQ(String::from_utf32(U"aé世\U0001F980").unwrap(), "aé世🦀"_s);
+    EXPECT_EQ(String::from_utf32(std::u32string({U'a', char32_t(0xD800)})).unwrap_err().pos, 1);
+    EXPECT_EQ(String::from_utf32(std::u32string({char32_t(0x110000)})).unwrap_err().pos, 0);
+
+    // The output is sized up front, so its length always matches exactly
+    const auto text = String::from_utf16_lossy(u"ASCII run, then \xD800 and 🦀🦀");
+    EXPECT_EQ(std::strlen(text.c_str()), text.size());
+}
+
+TEST(StringTest, FromUtf8Lossy)
+{
+    using namespace literal;
+
+    const auto valid = std::string("Hello, 世界");
+    const auto borrowed = String::from_utf8_lossy(valid.data(), valid.size());
+    EXPECT_TRUE(borrowed.is_borrowed());
+    EXPECT_EQ(borrowed.as_str(), "Hello, 世界"_s);
+    EXPECT_EQ(borrowed.as_str().data(), reinterpret_cast<const std::byte*>(valid.data()));
+
+    EXPECT_TRUE(String::from_utf8_lossy(nullptr, 0).is_borrowed());
+
+    // A truncated sequence is replaced once, a byte that cannot start a sequence is replaced on its own
+    const auto invalid = std::string("ab\xF0\x9F" "c\x80\x80 \xE4\xB8\x96\xE4");
+    const auto repaired = String::from_utf8_lossy(invalid.data(), invalid.size());
+    EXPECT_TRUE(repaired.is_owned());
+    EXPECT_EQ(repaired.as_str(), "ab�c�� 世�"_s);
+
+    // Surrogates and overlong encodings are invalid byte by byte
+    const auto surrogate = std::string("\xED\xA0\x80\xC0\xAF");
+    EXPECT_EQ(String::from_utf8_lossy(surrogate.data(), surrogate.size()).as_str(), "�����"_s);
+}
+
 #endif
@@ -31,7 +31,7 @@ target("crab_cpp")
 
     if has_config("enable-string") then
         add_packages("utf8proc")
-        add_files("src/string.cppm", {public = true})
+        add_files("src/string.cppm", "src/fs.cppm", "src/par.cppm", "src/rope.cppm", {public = true})
     end
 
     add_files("src/match.cppm", "src/mod.cppm", "src/option.cppm", "src/panic.cppm", "src/result.cppm", {public = true})
@@ -50,7 +50,7 @@ target("crab_cpp_test")
 
     if has_config("enable-string") then
         add_packages("utf8proc")
-        add_files("src/string.cppm")
+        add_files("src/string.cppm", "src/fs.cppm", "src/par.cppm", "src/rope.cppm")
     end
 
     add_packages("gtest")